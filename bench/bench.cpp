@@ -0,0 +1,488 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <libchess/movegen.hpp>
+#include <libchess/movelist.hpp>
+#include <libchess/perft.hpp>
+#include <libchess/position.hpp>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "corpus.hpp"
+
+namespace {
+
+struct Result {
+    std::string name;
+    double ns_per_op;
+    std::uint64_t ops;
+    // Against the 1 thread run, only set for the perft_parallel results
+    double speedup;
+};
+
+// What --compare checks against
+struct Baseline {
+    double ns_per_op;
+    double speedup;
+};
+
+// Fixed so results from different runs are comparable
+constexpr int perft_parallel_depth = 4;
+
+// Results are folded into this so the work can't be optimised away
+volatile std::uint64_t sink = 0;
+
+void consume(const std::uint64_t value) noexcept {
+    sink = sink ^ value;
+}
+
+// Calls f until min_ms have passed, f does one pass over the corpus and returns how many operations it did
+// Out of line so every benchmark is compiled into its own function rather than all of them into run_all()
+template <typename F>
+[[nodiscard, gnu::noinline]] Result run(const std::string &name, const int min_ms, F f) {
+    std::uint64_t ops = f();  // warm up
+    ops = 0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    auto t1 = t0;
+    do {
+        ops += f();
+        t1 = std::chrono::steady_clock::now();
+    } while (std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() < min_ms);
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    return {name, static_cast<double>(ns) / static_cast<double>(ops), ops, 0.0};
+}
+
+[[nodiscard]] double nodes_per_second(const Result &r) noexcept {
+    return 1e9 / r.ns_per_op;
+}
+
+[[nodiscard]] std::vector<Result> run_all(const int min_ms) {
+    bench::Data data;
+    const auto &positions = data.positions;
+    const auto &moves = data.moves;
+    const auto &move_lists = data.move_lists;
+    const auto &move_strings = data.move_strings;
+    const auto &san_strings = data.san_strings;
+    const auto &in_check = data.in_check;
+    auto &scratch = data.scratch;
+
+    std::vector<Result> results;
+
+    // Everything that starts from a copy of the corpus pays for this as well
+    results.push_back(run("position_copy", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        for (std::size_t i = 0; i < scratch.size(); ++i) {
+            scratch[i] = positions[i];
+            acc += scratch[i].hash();
+        }
+        consume(acc);
+        return scratch.size();
+    }));
+
+    results.push_back(run("makemove_undomove", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        std::uint64_t ops = 0;
+        for (std::size_t i = 0; i < scratch.size(); ++i) {
+            for (const auto &move : moves[i]) {
+                scratch[i].makemove(move);
+                acc += scratch[i].hash();
+                scratch[i].undomove();
+                ops++;
+            }
+        }
+        consume(acc);
+        return ops;
+    }));
+
+    results.push_back(run("makenull_undonull", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        std::uint64_t ops = 0;
+        for (std::size_t i = 0; i < scratch.size(); ++i) {
+            if (in_check[i]) {
+                continue;
+            }
+            for (int j = 0; j < 64; ++j) {
+                scratch[i].makenull();
+                acc += scratch[i].hash();
+                scratch[i].undonull();
+                ops++;
+            }
+        }
+        consume(acc);
+        return ops;
+    }));
+
+    results.push_back(run("legal_moves", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        libchess::MoveList list;
+        for (std::size_t i = 0; i < scratch.size(); ++i) {
+            scratch[i] = positions[i];
+            list.clear();
+            scratch[i].legal_moves(list);
+            acc += list.size();
+        }
+        consume(acc);
+        return scratch.size();
+    }));
+
+    results.push_back(run("legal_captures", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        libchess::MoveList list;
+        for (std::size_t i = 0; i < scratch.size(); ++i) {
+            scratch[i] = positions[i];
+            list.clear();
+            scratch[i].legal_captures(list);
+            acc += list.size();
+        }
+        consume(acc);
+        return scratch.size();
+    }));
+
+    results.push_back(run("legal_noncaptures", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        libchess::MoveList list;
+        for (std::size_t i = 0; i < scratch.size(); ++i) {
+            scratch[i] = positions[i];
+            list.clear();
+            scratch[i].legal_noncaptures(list);
+            acc += list.size();
+        }
+        consume(acc);
+        return scratch.size();
+    }));
+
+    results.push_back(run("count_moves", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        for (std::size_t i = 0; i < scratch.size(); ++i) {
+            scratch[i] = positions[i];
+            acc += scratch[i].count_moves();
+        }
+        consume(acc);
+        return scratch.size();
+    }));
+
+    results.push_back(run("set_fen", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        libchess::Position pos;
+        for (const auto &[fen, dfrc] : bench::corpus) {
+            pos.set_fen(fen, dfrc);
+            acc += pos.hash();
+        }
+        consume(acc);
+        return bench::corpus.size();
+    }));
+
+    results.push_back(run("get_fen", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            acc += positions[i].get_fen(bench::corpus[i].second).size();
+        }
+        consume(acc);
+        return positions.size();
+    }));
+
+    results.push_back(run("write_fen", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        char buffer[libchess::Position::max_fen_size];
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            acc += static_cast<std::uint64_t>(positions[i].write_fen(buffer, bench::corpus[i].second) - buffer);
+        }
+        consume(acc);
+        return positions.size();
+    }));
+
+    results.push_back(run("pack", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        libchess::PackedPosition packed;
+        for (const auto &pos : positions) {
+            acc += pos.pack(packed) ? packed.occupied : 0;
+        }
+        consume(acc);
+        return positions.size();
+    }));
+
+    std::vector<libchess::PackedPosition> packed(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        [[maybe_unused]] const auto ok = positions[i].pack(packed[i]);
+    }
+
+    results.push_back(run("unpack", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        libchess::Position pos;
+        for (const auto &p : packed) {
+            acc += pos.unpack(p) ? pos.hash() : 0;
+        }
+        consume(acc);
+        return packed.size();
+    }));
+
+    results.push_back(run("parse_move", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        std::uint64_t ops = 0;
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            for (const auto &str : move_strings[i]) {
+                acc += static_cast<unsigned int>(scratch[i].parse_move(str).from());
+                ops++;
+            }
+        }
+        consume(acc);
+        return ops;
+    }));
+
+    results.push_back(run("parse_san", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        std::uint64_t ops = 0;
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            for (const auto &str : san_strings[i]) {
+                acc += static_cast<unsigned int>(scratch[i].parse_san(str).from());
+                ops++;
+            }
+        }
+        consume(acc);
+        return ops;
+    }));
+
+    results.push_back(run("write_san", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        std::uint64_t ops = 0;
+        std::array<libchess::Position::SanString, libchess::MoveList::capacity> sans;
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            scratch[i].write_san(move_lists[i], sans.data());
+            acc += static_cast<std::uint64_t>(sans[0][0]);
+            ops += move_lists[i].size();
+        }
+        consume(acc);
+        return ops;
+    }));
+
+    results.push_back(run("predict_hash", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        std::uint64_t ops = 0;
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            for (const auto &move : moves[i]) {
+                acc += positions[i].predict_hash(move);
+                ops++;
+            }
+        }
+        consume(acc);
+        return ops;
+    }));
+
+    // The side to move's pins and king squares are cached, so these time the other side's from scratch
+    results.push_back(run("pinned", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        for (const auto &pos : positions) {
+            acc += pos.pinned(!pos.turn()).count();
+        }
+        consume(acc);
+        return positions.size();
+    }));
+
+    results.push_back(run("king_allowed", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        for (const auto &pos : positions) {
+            acc += pos.king_allowed(!pos.turn()).count();
+        }
+        consume(acc);
+        return positions.size();
+    }));
+
+    results.push_back(run("squares_attacked", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        for (const auto &pos : positions) {
+            acc += pos.squares_attacked(pos.turn()).count();
+        }
+        consume(acc);
+        return positions.size();
+    }));
+
+    results.push_back(run("calculate_state", min_ms, [&]() {
+        std::uint64_t acc = 0;
+        for (const auto &pos : positions) {
+            acc += pos.calculate_state(pos.turn()).king_allowed.count();
+        }
+        consume(acc);
+        return positions.size();
+    }));
+
+    // One op is a node, for 1, 2, 4... threads up to the hardware's, so a thread count that scales worse than before
+    // shows up in --compare
+    const auto max_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    const auto &perft_pos = positions[3];
+    double single_thread_ns = 0.0;
+    for (int threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        auto result = run("perft_parallel_" + std::to_string(threads) + "t", min_ms, [&]() {
+            const auto nodes = libchess::perft_parallel(perft_pos, perft_parallel_depth, threads);
+            consume(nodes);
+            return nodes;
+        });
+        if (threads == 1) {
+            single_thread_ns = result.ns_per_op;
+        }
+        result.speedup = single_thread_ns / result.ns_per_op;
+        results.push_back(result);
+
+        if (threads == max_threads) {
+            break;
+        }
+    }
+
+    return results;
+}
+
+void print_text(const std::vector<Result> &results) {
+    std::cout << "Sliders: " << libchess::movegen::slider_backend() << "\n";
+    for (const auto &r : results) {
+        std::cout << std::left << std::setw(20) << r.name;
+        std::cout << std::right << std::fixed << std::setprecision(2) << std::setw(12) << r.ns_per_op << " ns/op";
+        if (r.speedup > 0.0) {
+            std::cout << std::setw(12) << nodes_per_second(r) / 1e6 << " Mnodes/s" << std::setw(8) << r.speedup << "x";
+        }
+        std::cout << "\n";
+    }
+}
+
+void print_csv(const std::vector<Result> &results) {
+    std::cout << "name,ns_per_op,ops,nodes_per_s,speedup\n";
+    for (const auto &r : results) {
+        std::cout << r.name << "," << std::fixed << std::setprecision(3) << r.ns_per_op << "," << r.ops << ",";
+        if (r.speedup > 0.0) {
+            std::cout << std::setprecision(0) << nodes_per_second(r) << "," << std::setprecision(3) << r.speedup;
+        } else {
+            std::cout << ",";
+        }
+        std::cout << "\n";
+    }
+}
+
+void print_json(const std::vector<Result> &results) {
+    std::cout << "{\n";
+    std::cout << "  \"sliders\": \"" << libchess::movegen::slider_backend() << "\",\n";
+    std::cout << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto &r = results[i];
+        std::cout << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << std::fixed << std::setprecision(3)
+                  << r.ns_per_op << ", \"ops\": " << r.ops;
+        if (r.speedup > 0.0) {
+            std::cout << ", \"nodes_per_s\": " << std::setprecision(0) << nodes_per_second(r)
+                      << ", \"speedup\": " << std::setprecision(3) << r.speedup;
+        }
+        std::cout << "}";
+        std::cout << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n";
+    std::cout << "}\n";
+}
+
+// Reads a baseline previously written with --format csv, older ones without the speedup column still work
+[[nodiscard]] std::map<std::string, Baseline> read_baseline(const std::string &path) {
+    std::map<std::string, Baseline> baseline;
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);  // header
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string name;
+        std::string ns;
+        std::string ops;
+        std::string nps;
+        std::string speedup;
+        if (std::getline(ss, name, ',') && std::getline(ss, ns, ',')) {
+            baseline[name].ns_per_op = std::stod(ns);
+        }
+        if (std::getline(ss, ops, ',') && std::getline(ss, nps, ',') && std::getline(ss, speedup, ',') &&
+            !speedup.empty()) {
+            baseline[name].speedup = std::stod(speedup);
+        }
+    }
+    return baseline;
+}
+
+// Returns the number of benchmarks that got slower, or scaled worse, by more than the tolerance
+[[nodiscard]] int compare(const std::vector<Result> &results,
+                          const std::map<std::string, Baseline> &baseline,
+                          const double tolerance) {
+    int regressions = 0;
+    std::cout << "name,baseline_ns,ns_per_op,change_percent,status\n";
+    for (const auto &r : results) {
+        const auto it = baseline.find(r.name);
+        if (it == baseline.end()) {
+            std::cout << r.name << ",," << std::fixed << std::setprecision(3) << r.ns_per_op << ",,new\n";
+            continue;
+        }
+
+        const auto &base = it->second;
+        const auto change = 100.0 * (r.ns_per_op - base.ns_per_op) / base.ns_per_op;
+        const auto slower = change > tolerance;
+        // A thread count can keep its ns/op while the 1 thread run got faster, so the speedup is checked as well
+        const auto scaling = r.speedup > 0.0 && base.speedup > 0.0 &&
+                             100.0 * (base.speedup - r.speedup) / base.speedup > tolerance;
+        regressions += slower || scaling;
+
+        std::cout << r.name << "," << std::fixed << std::setprecision(3) << base.ns_per_op << "," << r.ns_per_op << ","
+                  << std::setprecision(1) << change << "," << (slower ? "slower" : scaling ? "scaling" : "ok") << "\n";
+    }
+    return regressions;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string format = "text";
+    std::string baseline_path;
+    double tolerance = 10.0;
+    int min_ms = 200;
+
+    for (int i = 1; i < argc; ++i) {
+        const auto arg = std::string(argv[i]);
+        const auto has_value = i + 1 < argc;
+        if (arg == "--format" && has_value) {
+            format = argv[++i];
+        } else if (arg == "--compare" && has_value) {
+            baseline_path = argv[++i];
+        } else if (arg == "--tolerance" && has_value) {
+            tolerance = std::stod(argv[++i]);
+        } else if (arg == "--time" && has_value) {
+            min_ms = std::max(std::stoi(argv[++i]), 1);
+        } else {
+            std::cerr << "Usage: libchess_bench [--format text|csv|json] [--time ms] [--compare baseline.csv "
+                         "[--tolerance percent]]\n";
+            return 2;
+        }
+    }
+
+    if (format != "text" && format != "csv" && format != "json") {
+        std::cerr << "Unknown format " << format << "\n";
+        return 2;
+    }
+
+    const auto results = run_all(min_ms);
+
+    if (!baseline_path.empty()) {
+        const auto baseline = read_baseline(baseline_path);
+        if (baseline.empty()) {
+            std::cerr << "Couldn't read a baseline from " << baseline_path << "\n";
+            return 2;
+        }
+        const auto regressions = compare(results, baseline, tolerance);
+        return regressions > 0 ? 1 : 0;
+    }
+
+    if (format == "csv") {
+        print_csv(results);
+    } else if (format == "json") {
+        print_json(results);
+    } else {
+        print_text(results);
+    }
+
+    return 0;
+}
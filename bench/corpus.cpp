@@ -0,0 +1,41 @@
+#include "corpus.hpp"
+
+namespace bench {
+
+const std::vector<std::pair<std::string, bool>> corpus = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", false},
+    {"rnbqkb1r/pp1p1ppp/4pn2/2p5/2PP4/2N5/PP2PPPP/R1BQKBNR w KQkq - 0 4", false},
+    {"r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/3P1N2/PPP2PPP/RNBQK2R w KQkq - 1 5", false},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", false},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", false},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", false},
+    {"2r3k1/pp3ppp/4p3/3p4/3P4/2P1P3/PP3PPP/2R3K1 b - - 0 24", false},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", false},
+    {"8/5pk1/6p1/8/3K4/8/5PPP/8 w - - 0 40", false},
+    {"8/PPPk4/8/8/8/8/4Kppp/8 w - - 0 1", false},
+    {"bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9", true},
+    {"2nnrbkr/p1qppppp/8/1ppb4/6PP/3PP3/PPP2P2/BQNNRBKR w HEhe - 1 9", true},
+    {"qbbnnrkr/2pp2pp/p7/1p2pp2/8/P3PP2/1PPP1KPP/QBBNNR1R w hf - 0 9", true},
+};
+
+Data::Data() {
+    for (const auto &[fen, dfrc] : corpus) {
+        positions.emplace_back(fen, dfrc);
+        scratch.push_back(positions.back());
+        const auto copy = positions.back();
+        moves.push_back(copy.legal_moves());
+        move_lists.emplace_back();
+        copy.legal_moves(move_lists.back());
+        move_strings.emplace_back();
+        san_strings.emplace_back();
+        for (const auto &move : moves.back()) {
+            move_strings.back().push_back(copy.move_string(move, dfrc));
+            san_strings.back().push_back(copy.san_string(move));
+        }
+        in_check.push_back(copy.in_check());
+    }
+}
+
+Data::~Data() = default;
+
+}  // namespace bench
@@ -0,0 +1,34 @@
+#ifndef LIBCHESS_BENCH_CORPUS_HPP
+#define LIBCHESS_BENCH_CORPUS_HPP
+
+#include <libchess/movelist.hpp>
+#include <libchess/position.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Opening through endgame, then a few Chess960 positions
+extern const std::vector<std::pair<std::string, bool>> corpus;
+
+// Everything the benchmarks work on, built from the corpus in its own translation unit so none of the setup gets
+// inlined into the timed code
+struct Data {
+    Data();
+    ~Data();
+
+    // The positions are kept without their cached state so a copy has to calculate it again
+    std::vector<libchess::Position> positions;
+    std::vector<std::vector<libchess::Move>> moves;
+    std::vector<libchess::MoveList> move_lists;
+    std::vector<std::vector<std::string>> move_strings;
+    std::vector<std::vector<std::string>> san_strings;
+    std::vector<bool> in_check;
+    // Assigned to rather than copy constructed so the history keeps its capacity between passes
+    std::vector<libchess::Position> scratch;
+};
+
+}  // namespace bench
+
+#endif
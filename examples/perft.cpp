@@ -1,22 +1,38 @@
 #include <chrono>
 #include <iostream>
+#include <libchess/movegen.hpp>
+#include <libchess/perft.hpp>
 #include <libchess/position.hpp>
+#include <string>
+#include <vector>
 
 int main(int argc, char **argv) {
     int depth = 6;
     std::string fen;
 
-    if (argc > 1) {
-        depth = std::stoi(std::string(argv[1]));
+    int threads = 1;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; ++i) {
+        const auto arg = std::string(argv[i]);
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(std::stoi(std::string(argv[++i])), 1);
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (!args.empty()) {
+        depth = std::stoi(args[0]);
         depth = std::max(depth, 1);
     }
 
-    if (argc > 2) {
-        for (int i = 2; i < argc; ++i) {
+    if (args.size() > 1) {
+        for (std::size_t i = 1; i < args.size(); ++i) {
             if (fen.empty()) {
-                fen = std::string(argv[i]);
+                fen = args[i];
             } else {
-                fen += " " + std::string(argv[i]);
+                fen += " " + args[i];
             }
         }
     } else {
@@ -26,11 +42,13 @@ int main(int argc, char **argv) {
     auto pos = libchess::Position(fen, true);
 
     std::cout << pos << std::endl;
+    std::cout << "Sliders: " << libchess::movegen::slider_backend() << std::endl;
+    std::cout << "Threads: " << threads << std::endl;
     std::cout << std::endl;
 
     for (int i = 0; i <= depth; ++i) {
         const auto t0 = std::chrono::high_resolution_clock::now();
-        const auto nodes = pos.perft(i);
+        const auto nodes = libchess::perft_parallel(pos, i, threads);
         const auto t1 = std::chrono::high_resolution_clock::now();
         const auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
 
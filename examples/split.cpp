@@ -1,22 +1,37 @@
 #include <chrono>
 #include <iostream>
+#include <libchess/perft.hpp>
 #include <libchess/position.hpp>
+#include <string>
+#include <vector>
 
 int main(int argc, char **argv) {
     int depth = 1;
     std::string fen;
 
-    if (argc > 1) {
-        depth = std::stoi(std::string(argv[1]));
+    int threads = 1;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; ++i) {
+        const auto arg = std::string(argv[i]);
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(std::stoi(std::string(argv[++i])), 1);
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (!args.empty()) {
+        depth = std::stoi(args[0]);
         depth = std::max(depth, 1);
     }
 
-    if (argc > 2) {
-        for (int i = 2; i < argc; ++i) {
+    if (args.size() > 1) {
+        for (std::size_t i = 1; i < args.size(); ++i) {
             if (fen.empty()) {
-                fen = std::string(argv[i]);
+                fen = args[i];
             } else {
-                fen += " " + std::string(argv[i]);
+                fen += " " + args[i];
             }
         }
     } else {
@@ -26,6 +41,7 @@ int main(int argc, char **argv) {
     auto pos = libchess::Position(fen, true);
 
     std::cout << pos << std::endl;
+    std::cout << "Threads: " << threads << std::endl;
     std::cout << std::endl;
 
     const auto moves = pos.legal_moves();
@@ -38,7 +54,7 @@ int main(int argc, char **argv) {
         std::cout << move << ": ";
 
         pos.makemove(move);
-        const auto nodes = pos.perft(depth - 1);
+        const auto nodes = libchess::perft_parallel(pos, depth - 1, threads);
         pos.undomove();
 
         sum += nodes;
@@ -1,5 +1,7 @@
 #include <chrono>
 #include <iostream>
+#include <libchess/movegen.hpp>
+#include <libchess/perft.hpp>
 #include <libchess/position.hpp>
 #include <string>
 #include <vector>
@@ -133,7 +135,14 @@ const std::pair<std::string, std::vector<std::uint64_t>> suite[] = {
     {"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", {24, 496, 9483, 182838, 3605103, 71179139}},
 };
 
-int main() {
+int main(int argc, char **argv) {
+    int threads = 1;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--threads") {
+            threads = std::max(std::stoi(std::string(argv[i + 1])), 1);
+        }
+    }
+
     std::uint64_t total = 0;
     const auto t0 = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < 6; ++i) {
@@ -144,7 +153,7 @@ int main() {
 
             auto pos = libchess::Position(fen);
             const auto exp = nodes[i];
-            const auto got = pos.perft(i + 1);
+            const auto got = libchess::perft_parallel(pos, i + 1, threads);
 
             total += exp;
 
@@ -164,6 +173,8 @@ int main() {
     const auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
 
     std::cout << "Positions: " << std::size(suite) << "\n";
+    std::cout << "Sliders: " << libchess::movegen::slider_backend() << "\n";
+    std::cout << "Threads: " << threads << "\n";
     std::cout << "Time: " << dt.count() << "ms\n";
     std::cout << "Nodes: " << total << "\n";
     if (dt.count() > 0) {
@@ -1,5 +1,6 @@
 #include <chrono>
 #include <iostream>
+#include <libchess/movegen.hpp>
 #include <libchess/position.hpp>
 #include <string>
 #include <vector>
@@ -1001,6 +1002,7 @@ int main() {
     const auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
 
     std::cout << "Positions: " << std::size(suite) << "\n";
+    std::cout << "Sliders: " << libchess::movegen::slider_backend() << "\n";
     std::cout << "Time: " << dt.count() << "ms\n";
     std::cout << "Nodes: " << total << "\n";
     if (dt.count() > 0) {
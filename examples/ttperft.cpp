@@ -1,15 +1,14 @@
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <libchess/movegen.hpp>
 #include <libchess/position.hpp>
-#include "tt.hpp"
+#include <libchess/tt.hpp>
+#include <string>
+#include <thread>
+#include <vector>
 
-struct TTEntry {
-    std::uint64_t hash;
-    std::uint64_t nodes;
-    std::uint8_t depth;
-};
-
-[[nodiscard]] std::uint64_t ttperft(TT<TTEntry> &tt, libchess::Position &pos, const std::uint8_t depth) {
+[[nodiscard]] std::uint64_t ttperft(libchess::TT &tt, libchess::Position &pos, const int depth) {
     if (depth == 0) {
         return 1;
     } else if (depth == 1) {
@@ -17,14 +16,16 @@ struct TTEntry {
     }
 
     // Poll TT
-    const auto &entry = tt.poll(pos.hash());
-    if (pos.hash() == entry.hash && entry.depth == depth) {
-        return entry.nodes;
+    std::uint64_t nodes = 0;
+    int entry_depth = 0;
+    if (tt.probe(pos.hash(), nodes, entry_depth) && entry_depth == depth) {
+        return nodes;
     }
 
-    std::uint64_t nodes = 0;
+    nodes = 0;
 
-    const auto moves = pos.legal_moves();
+    libchess::MoveList moves;
+    pos.legal_moves(moves);
     for (const auto &move : moves) {
         pos.makemove(move);
         nodes += ttperft(tt, pos, depth - 1);
@@ -32,41 +33,89 @@ struct TTEntry {
     }
 
     // Create TT entry
-    tt.add(pos.hash(), {pos.hash(), nodes, depth});
+    tt.store(pos.hash(), nodes, depth);
 
     return nodes;
 }
 
+// The root moves are shared out between threads, which all use the same table
+[[nodiscard]] std::uint64_t ttperft_threaded(libchess::TT &tt,
+                                             const libchess::Position &pos,
+                                             const int depth,
+                                             const int threads) {
+    if (threads <= 1 || depth <= 1) {
+        auto copy = pos;
+        return ttperft(tt, copy, depth);
+    }
+
+    const auto moves = pos.legal_moves();
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::uint64_t> total{0};
+
+    const auto worker = [&]() {
+        auto local = pos;
+        for (auto idx = next++; idx < moves.size(); idx = next++) {
+            local.makemove(moves[idx]);
+            total += ttperft(tt, local, depth - 1);
+            local.undomove();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto &t : workers) {
+        t.join();
+    }
+
+    return total;
+}
+
 int main(int argc, char **argv) {
     int depth = 6;
     std::string fen;
 
-    if (argc > 1) {
-        depth = std::stoi(std::string(argv[1]));
+    int threads = 1;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; ++i) {
+        const auto arg = std::string(argv[i]);
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(std::stoi(std::string(argv[++i])), 1);
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (!args.empty()) {
+        depth = std::stoi(args[0]);
         depth = std::max(depth, 1);
     }
 
-    if (argc > 2) {
-        for (int i = 2; i < argc; ++i) {
+    if (args.size() > 1) {
+        for (std::size_t i = 1; i < args.size(); ++i) {
             if (fen.empty()) {
-                fen = std::string(argv[i]);
+                fen = args[i];
             } else {
-                fen += " " + std::string(argv[i]);
+                fen += " " + args[i];
             }
         }
     } else {
         fen = "startpos";
     }
 
-    TT<TTEntry> tt{256};
+    libchess::TT tt{256};
     auto pos = libchess::Position(fen, true);
 
     std::cout << pos << std::endl;
+    std::cout << "Sliders: " << libchess::movegen::slider_backend() << std::endl;
+    std::cout << "Threads: " << threads << std::endl;
     std::cout << std::endl;
 
     for (int i = 0; i <= depth; ++i) {
         const auto t0 = std::chrono::high_resolution_clock::now();
-        const auto nodes = ttperft(tt, pos, i);
+        const auto nodes = ttperft_threaded(tt, pos, i, threads);
         const auto t1 = std::chrono::high_resolution_clock::now();
         const auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
 
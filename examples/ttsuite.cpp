@@ -1,17 +1,12 @@
 #include <chrono>
 #include <iostream>
+#include <libchess/movegen.hpp>
 #include <libchess/position.hpp>
+#include <libchess/tt.hpp>
 #include <string>
 #include <vector>
-#include "tt.hpp"
 
-struct TTEntry {
-    std::uint64_t hash;
-    std::uint64_t nodes;
-    std::uint8_t depth;
-};
-
-[[nodiscard]] std::uint64_t ttperft(TT<TTEntry> &tt, libchess::Position &pos, const std::uint8_t depth) {
+[[nodiscard]] std::uint64_t ttperft(libchess::TT &tt, libchess::Position &pos, const int depth) {
     if (depth == 0) {
         return 1;
     } else if (depth == 1) {
@@ -19,14 +14,16 @@ struct TTEntry {
     }
 
     // Poll TT
-    const auto &entry = tt.poll(pos.hash());
-    if (pos.hash() == entry.hash && entry.depth == depth) {
-        return entry.nodes;
+    std::uint64_t nodes = 0;
+    int entry_depth = 0;
+    if (tt.probe(pos.hash(), nodes, entry_depth) && entry_depth == depth) {
+        return nodes;
     }
 
-    std::uint64_t nodes = 0;
+    nodes = 0;
 
-    const auto moves = pos.legal_moves();
+    libchess::MoveList moves;
+    pos.legal_moves(moves);
     for (const auto &move : moves) {
         pos.makemove(move);
         nodes += ttperft(tt, pos, depth - 1);
@@ -34,7 +31,7 @@ struct TTEntry {
     }
 
     // Create TT entry
-    tt.add(pos.hash(), {pos.hash(), nodes, depth});
+    tt.store(pos.hash(), nodes, depth);
 
     return nodes;
 }
@@ -169,7 +166,7 @@ const std::pair<std::string, std::vector<std::uint64_t>> suite[] = {
 };
 
 int main() {
-    TT<TTEntry> tt{128};
+    libchess::TT tt{128};
 
     std::uint64_t total = 0;
     const auto t0 = std::chrono::high_resolution_clock::now();
@@ -201,6 +198,7 @@ int main() {
     const auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
 
     std::cout << "Positions: " << std::size(suite) << "\n";
+    std::cout << "Sliders: " << libchess::movegen::slider_backend() << "\n";
     std::cout << "Time: " << dt.count() << "ms\n";
     std::cout << "Nodes: " << total << "\n";
     if (dt.count() > 0) {
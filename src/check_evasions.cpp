@@ -4,9 +4,13 @@
 namespace libchess {
 
 [[nodiscard]] std::vector<Move> Position::check_evasions() const noexcept {
-    std::vector<Move> moves;
-    moves.reserve(8);
+    MoveList moves;
+    check_evasions(moves);
+    return {moves.begin(), moves.end()};
+}
 
+void Position::check_evasions(MoveList &moves) const noexcept {
+    [[maybe_unused]] const auto start_size = moves.size();
     const auto ksq = king_position(turn());
     const auto safe = king_allowed(turn());
     const auto mask = movegen::king_moves(ksq) & safe;
@@ -24,9 +28,7 @@ namespace libchess {
         moves.emplace_back(MoveType::Normal, ksq, to, Piece::King);
     }
 
-    assert(moves.size() <= 8);
-
-    return moves;
+    assert(moves.size() - start_size <= 8);
 }
 
 }  // namespace libchess
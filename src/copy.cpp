@@ -0,0 +1,9 @@
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+Position::Position(const Position &other) = default;
+
+Position &Position::operator=(const Position &other) = default;
+
+}  // namespace libchess
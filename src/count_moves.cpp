@@ -1,9 +1,182 @@
+#include <cassert>
+#include "libchess/movegen.hpp"
 #include "libchess/position.hpp"
 
 namespace libchess {
 
+namespace {
+
+// Count the legal moves of side "us" without generating them
+// Pieces of type "only" are counted, or every piece if "only" is Piece::None
+[[nodiscard]] std::size_t count_legal(const Position &pos, const Side us, const Piece only) noexcept {
+    const auto want = [only](const Piece p) {
+        return only == Piece::None || only == p;
+    };
+
+    const auto them = !us;
+    const auto ksq = pos.king_position(us);
+    const auto occ = pos.occupied();
+    const auto st = us == pos.turn() ? pos.state() : pos.calculate_state(us);
+    const auto checkers = st.checkers;
+    std::size_t count = 0;
+
+    // King -- king_allowed already excludes friendly pieces and attacked squares
+    if (want(Piece::King)) {
+        count += (movegen::king_moves(ksq) & st.king_allowed).count();
+    }
+
+    // If we're in check multiple times, only the king can move
+    if (checkers.count() > 1) {
+        return count;
+    }
+
+    // Squares our pieces may move to
+    const auto target = ~pos.occupancy(us) & ~pos.pieces(them, Piece::King) & st.check_mask;
+
+    // Pins
+    const auto bq = pos.pieces(them, Piece::Bishop) | pos.pieces(them, Piece::Queen);
+    const auto rq = pos.pieces(them, Piece::Rook) | pos.pieces(them, Piece::Queen);
+    const auto pinned_bishop = st.pinned_diagonal;
+    const auto pinned_rook = st.pinned_orthogonal;
+    const auto pinned = pinned_bishop | pinned_rook;
+    const auto bishop_xrays = st.diagonal_pin_rays;
+    const auto rook_xrays = st.orthogonal_pin_rays;
+
+    // Pawns
+    if (want(Piece::Pawn)) {
+        const auto pawns = pos.pieces(us, Piece::Pawn);
+        const auto enemy = pos.occupancy(them) & target;
+        const auto promo_rank = us == Side::White ? bitboards::Rank8 : bitboards::Rank1;
+        const auto double_rank = us == Side::White ? bitboards::Rank4 : bitboards::Rank5;
+        const auto forward = [us](const Bitboard bb) {
+            return us == Side::White ? bb.north() : bb.south();
+        };
+
+        // Pushes -- pawns pinned along their file are still free to push
+        const auto pushers = pawns & ~pinned_bishop & ~(pinned_rook & bitboards::ranks[ksq.rank()]);
+        const auto singles = forward(pushers) & pos.empty();
+        const auto doubles = forward(singles) & pos.empty() & double_rank & target;
+        count += (singles & target & ~promo_rank).count();
+        count += 4 * (singles & target & promo_rank).count();
+        count += doubles.count();
+
+        // Captures -- diagonally pinned pawns may only capture along the pin
+        const auto free = pawns & ~pinned;
+        const auto diag = pawns & pinned_bishop;
+        const auto caps_east = (forward(free).east() | (forward(diag).east() & bishop_xrays)) & enemy;
+        const auto caps_west = (forward(free).west() | (forward(diag).west() & bishop_xrays)) & enemy;
+        count += (caps_east & ~promo_rank).count() + (caps_west & ~promo_rank).count();
+        count += 4 * ((caps_east & promo_rank).count() + (caps_west & promo_rank).count());
+
+        // En passant -- only ever available to the side to move
+        if (us == pos.turn() && pos.ep() != squares::OffSq) {
+            const auto ep_bb = Bitboard{pos.ep()};
+            const auto captured = us == Side::White ? ep_bb.south() : ep_bb.north();
+            const auto capturers = us == Side::White ? (ep_bb.south().east() | ep_bb.south().west())
+                                                     : (ep_bb.north().east() | ep_bb.north().west());
+
+            const auto enemy_pawns = pos.pieces(them, Piece::Pawn) ^ captured;
+            const auto pawn_checks = forward(Bitboard{ksq}).east() | forward(Bitboard{ksq}).west();
+
+            for (const auto &fr : capturers & pawns) {
+                const auto blockers = occ ^ Bitboard{fr} ^ captured ^ ep_bb;
+                const auto attacked = (movegen::bishop_moves(ksq, blockers) & bq) |
+                                      (movegen::rook_moves(ksq, blockers) & rq) |
+                                      (movegen::knight_moves(ksq) & pos.pieces(them, Piece::Knight)) |
+                                      (pawn_checks & enemy_pawns);
+                count += attacked.empty();
+            }
+        }
+    }
+
+    // Knights -- a pinned knight can never move
+    if (want(Piece::Knight)) {
+        for (const auto &fr : pos.pieces(us, Piece::Knight) & ~pinned) {
+            count += (movegen::knight_moves(fr) & target).count();
+        }
+    }
+
+    // Bishops
+    if (want(Piece::Bishop)) {
+        for (const auto &fr : pos.pieces(us, Piece::Bishop) & ~pinned) {
+            count += (movegen::bishop_moves(fr, occ) & target).count();
+        }
+        for (const auto &fr : pos.pieces(us, Piece::Bishop) & pinned_bishop) {
+            count += (movegen::bishop_moves(fr, occ) & target & bishop_xrays).count();
+        }
+    }
+
+    // Rooks
+    if (want(Piece::Rook)) {
+        for (const auto &fr : pos.pieces(us, Piece::Rook) & ~pinned) {
+            count += (movegen::rook_moves(fr, occ) & target).count();
+        }
+        for (const auto &fr : pos.pieces(us, Piece::Rook) & pinned_rook) {
+            count += (movegen::rook_moves(fr, occ) & target & rook_xrays).count();
+        }
+    }
+
+    // Queens
+    if (want(Piece::Queen)) {
+        for (const auto &fr : pos.pieces(us, Piece::Queen) & ~pinned) {
+            count += (movegen::queen_moves(fr, occ) & target).count();
+        }
+        for (const auto &fr : pos.pieces(us, Piece::Queen) & pinned_bishop) {
+            count += (movegen::bishop_moves(fr, occ) & target & bishop_xrays).count();
+        }
+        for (const auto &fr : pos.pieces(us, Piece::Queen) & pinned_rook) {
+            count += (movegen::rook_moves(fr, occ) & target & rook_xrays).count();
+        }
+    }
+
+    // Castling
+    if (want(Piece::King) && !checkers) {
+        const Square king_to[] = {castle_king_to[us * 2], castle_king_to[us * 2 + 1]};
+        const Square rook_to[] = {ksc_rook_to[us], qsc_rook_to[us]};
+        const MoveType types[] = {MoveType::ksc, MoveType::qsc};
+
+        for (int i = 0; i < 2; ++i) {
+            if (!pos.can_castle(us, types[i])) {
+                continue;
+            }
+
+            const auto rook_from = pos.get_castling_square(us, types[i]);
+            const auto blockers = occ ^ Bitboard(ksq) ^ Bitboard(rook_from);
+            const auto king_path = (squares_between(ksq, king_to[i]) | Bitboard(king_to[i])) & ~Bitboard(ksq);
+            const auto rook_path = squares_between(rook_to[i], rook_from) | Bitboard(rook_to[i]);
+
+            if ((king_path & blockers) || (rook_path & blockers) || (pinned_rook & rook_from)) {
+                continue;
+            }
+
+            if (!(pos.squares_attacked(them) & king_path)) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+}  // namespace
+
 [[nodiscard]] std::size_t Position::count_moves() const noexcept {
-    return legal_moves().size();
+    const auto count = count_legal(*this, turn(), Piece::None);
+#ifndef NDEBUG
+    MoveList moves;
+    legal_moves(moves);
+    assert(count == moves.size());
+#endif
+    return count;
+}
+
+[[nodiscard]] std::size_t Position::count_moves(const Side s) const noexcept {
+    return count_legal(*this, s, Piece::None);
+}
+
+[[nodiscard]] std::size_t Position::count_moves(const Side s, const Piece p) const noexcept {
+    assert(p != Piece::None);
+    return count_legal(*this, s, p);
 }
 
 }  // namespace libchess
@@ -1,120 +1,91 @@
+#include <charconv>
 #include "libchess/position.hpp"
 
 namespace libchess {
 
-[[nodiscard]] std::string fen_pieces(const Position &pos) noexcept {
-    const char piece_chars[2][6] = {
+char *Position::write_fen(char *out, const bool dfrc) const noexcept {
+    constexpr char piece_chars[2][6] = {
         {'P', 'N', 'B', 'R', 'Q', 'K'},
         {'p', 'n', 'b', 'r', 'q', 'k'},
     };
+    const auto black = occupancy(Side::Black);
 
-    std::string fen;
-
+    // Pieces, one pass over the mailbox
     for (int y = 7; y >= 0; --y) {
         int num_empty = 0;
 
         for (int x = 0; x < 8; ++x) {
             const auto sq = Square{x, y};
-            const auto bb = Bitboard{sq};
-            const auto piece = pos.piece_on(sq);
+            const auto piece = mailbox_[static_cast<int>(sq)];
 
             if (piece == Piece::None) {
                 num_empty++;
-            } else {
-                // Add the number of empty squares so far
-                if (num_empty > 0) {
-                    fen += std::to_string(num_empty);
-                }
-                num_empty = 0;
+                continue;
+            }
 
-                const auto gg = static_cast<bool>(pos.occupancy(Side::Black) & bb);
-                fen += piece_chars[gg][piece];
+            // Add the number of empty squares so far
+            if (num_empty > 0) {
+                *out++ = static_cast<char>('0' + num_empty);
+                num_empty = 0;
             }
+
+            *out++ = piece_chars[black.get(sq)][piece];
         }
 
         // Add the number of empty squares when we reach the end of the rank
         if (num_empty > 0) {
-            fen += std::to_string(num_empty);
+            *out++ = static_cast<char>('0' + num_empty);
         }
 
         if (y > 0) {
-            fen += "/";
+            *out++ = '/';
         }
     }
 
-    return fen;
-}
+    // Side to move
+    *out++ = ' ';
+    *out++ = turn() == Side::White ? 'w' : 'b';
+    *out++ = ' ';
 
-[[nodiscard]] std::string fen_side(const Position &pos) noexcept {
-    return pos.turn() == Side::White ? "w" : "b";
-}
-
-[[nodiscard]] std::string fen_castling(const Position &pos, const bool dfrc) noexcept {
-    std::string part;
-
-    if (dfrc) {
-        if (pos.can_castle(Side::White, MoveType::ksc)) {
-            const auto sq = pos.get_castling_square(Side::White, MoveType::ksc);
-            part += 'A' + sq.file();
-        }
-        if (pos.can_castle(Side::White, MoveType::qsc)) {
-            const auto sq = pos.get_castling_square(Side::White, MoveType::qsc);
-            part += 'A' + sq.file();
-        }
-        if (pos.can_castle(Side::Black, MoveType::ksc)) {
-            const auto sq = pos.get_castling_square(Side::Black, MoveType::ksc);
-            part += 'a' + sq.file();
-        }
-        if (pos.can_castle(Side::Black, MoveType::qsc)) {
-            const auto sq = pos.get_castling_square(Side::Black, MoveType::qsc);
-            part += 'a' + sq.file();
-        }
-    } else {
-        if (pos.can_castle(Side::White, MoveType::ksc)) {
-            part += "K";
-        }
-        if (pos.can_castle(Side::White, MoveType::qsc)) {
-            part += "Q";
-        }
-        if (pos.can_castle(Side::Black, MoveType::ksc)) {
-            part += "k";
-        }
-        if (pos.can_castle(Side::Black, MoveType::qsc)) {
-            part += "q";
-        }
+    // Castling permissions
+    char *const castling = out;
+    if (can_castle(Side::White, MoveType::ksc)) {
+        *out++ = dfrc ? static_cast<char>('A' + get_castling_square(Side::White, MoveType::ksc).file()) : 'K';
     }
-
-    if (part.empty()) {
-        return "-";
+    if (can_castle(Side::White, MoveType::qsc)) {
+        *out++ = dfrc ? static_cast<char>('A' + get_castling_square(Side::White, MoveType::qsc).file()) : 'Q';
     }
+    if (can_castle(Side::Black, MoveType::ksc)) {
+        *out++ = dfrc ? static_cast<char>('a' + get_castling_square(Side::Black, MoveType::ksc).file()) : 'k';
+    }
+    if (can_castle(Side::Black, MoveType::qsc)) {
+        *out++ = dfrc ? static_cast<char>('a' + get_castling_square(Side::Black, MoveType::qsc).file()) : 'q';
+    }
+    if (out == castling) {
+        *out++ = '-';
+    }
+    *out++ = ' ';
 
-    return part;
-}
-
-[[nodiscard]] std::string fen_enpassant(const Position &pos) noexcept {
-    if (pos.ep() == squares::OffSq) {
-        return "-";
+    // En passant square
+    if (ep() == squares::OffSq) {
+        *out++ = '-';
     } else {
-        return square_strings[static_cast<int>(pos.ep())];
+        *out++ = static_cast<char>('a' + ep().file());
+        *out++ = static_cast<char>('1' + ep().rank());
     }
-}
 
-[[nodiscard]] std::string fen_halfmoves(const Position &pos) noexcept {
-    return std::to_string(pos.halfmoves());
-}
+    // Move counters, 20 digits fit any std::size_t
+    *out++ = ' ';
+    out = std::to_chars(out, out + 20, halfmoves()).ptr;
+    *out++ = ' ';
+    out = std::to_chars(out, out + 20, fullmoves()).ptr;
 
-[[nodiscard]] std::string fen_fullmoves(const Position &pos) noexcept {
-    return std::to_string(pos.fullmoves());
+    return out;
 }
 
 [[nodiscard]] std::string Position::get_fen(const bool dfrc) const noexcept {
-    std::string fen = fen_pieces(*this);
-    fen += " " + fen_side(*this);
-    fen += " " + fen_castling(*this, dfrc);
-    fen += " " + fen_enpassant(*this);
-    fen += " " + fen_halfmoves(*this);
-    fen += " " + fen_fullmoves(*this);
-    return fen;
+    char buffer[max_fen_size];
+    return std::string(buffer, write_fen(buffer, dfrc));
 }
 
 }  // namespace libchess
@@ -0,0 +1,125 @@
+#include <cassert>
+#include "libchess/movegen.hpp"
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+[[nodiscard]] Position::CheckInfo Position::calculate_check_info() const noexcept {
+    const auto us = turn();
+    const auto them = !us;
+    const auto ksq = king_position(them);
+    const auto ksq_bb = Bitboard{ksq};
+    const auto occ = occupied();
+    CheckInfo info;
+
+    // Direct checks
+    const auto bishop_rays = movegen::bishop_moves(ksq, occ);
+    const auto rook_rays = movegen::rook_moves(ksq, occ);
+    info.check_squares[Piece::Pawn] =
+        us == Side::White ? ksq_bb.south().east() | ksq_bb.south().west() : ksq_bb.north().east() | ksq_bb.north().west();
+    info.check_squares[Piece::Knight] = movegen::knight_moves(ksq);
+    info.check_squares[Piece::Bishop] = bishop_rays;
+    info.check_squares[Piece::Rook] = rook_rays;
+    info.check_squares[Piece::Queen] = bishop_rays | rook_rays;
+    info.check_squares[Piece::King] = Bitboard{};
+
+    // Discovered checks -- the same x-ray as finding pins, but from the enemy king towards our sliders
+    const auto bq = pieces(us, Piece::Bishop) | pieces(us, Piece::Queen);
+    const auto rq = pieces(us, Piece::Rook) | pieces(us, Piece::Queen);
+    const auto bishop_candidates = bishop_rays & occupancy(us);
+    const auto rook_candidates = rook_rays & occupancy(us);
+
+    for (const auto &sq : movegen::bishop_moves(ksq, occ ^ bishop_candidates) & ~bishop_rays & bq) {
+        info.discoverers |= squares_between(ksq, sq) & bishop_candidates;
+    }
+    for (const auto &sq : movegen::rook_moves(ksq, occ ^ rook_candidates) & ~rook_rays & rq) {
+        info.discoverers |= squares_between(ksq, sq) & rook_candidates;
+    }
+
+    return info;
+}
+
+[[nodiscard]] Bitboard Position::checkers_after(const Move &move) const noexcept {
+    const auto &ci = check_info();
+    const auto us = turn();
+    const auto them = !us;
+    const auto ksq = king_position(them);
+    const auto from = move.from();
+    const auto to = move.to();
+    const auto from_bb = Bitboard{from};
+    const auto to_bb = Bitboard{to};
+    const auto bq = pieces(us, Piece::Bishop) | pieces(us, Piece::Queen);
+    const auto rq = pieces(us, Piece::Rook) | pieces(us, Piece::Queen);
+
+    // Our sliders that see the king once the board looks like "occ"
+    const auto sliders = [ksq](const Bitboard occ, const Bitboard diagonal, const Bitboard orthogonal) {
+        return (movegen::bishop_moves(ksq, occ) & diagonal) | (movegen::rook_moves(ksq, occ) & orthogonal);
+    };
+
+    switch (move.type()) {
+        case MoveType::Normal:
+        case MoveType::Capture:
+        case MoveType::Double: {
+            auto checkers = ci.check_squares[move.piece()] & to_bb;
+            if (ci.discoverers & from_bb) {
+                checkers |= sliders((occupied() ^ from_bb) | to_bb, bq & ~from_bb, rq & ~from_bb);
+            }
+            return checkers;
+        }
+        case MoveType::promo:
+        case MoveType::promo_capture: {
+            // The promoted piece may see the king through the square the pawn just left
+            const auto occ = (occupied() ^ from_bb) | to_bb;
+            Bitboard attacks;
+            switch (move.promotion()) {
+                case Piece::Knight:
+                    attacks = movegen::knight_moves(to);
+                    break;
+                case Piece::Bishop:
+                    attacks = movegen::bishop_moves(to, occ);
+                    break;
+                case Piece::Rook:
+                    attacks = movegen::rook_moves(to, occ);
+                    break;
+                case Piece::Queen:
+                    attacks = movegen::queen_moves(to, occ);
+                    break;
+                case Piece::Pawn:
+                case Piece::King:
+                case Piece::None:
+                default:
+                    assert(false);
+                    break;
+            }
+
+            auto checkers = (attacks & Bitboard{ksq}) ? to_bb : Bitboard{};
+            if (ci.discoverers & from_bb) {
+                checkers |= sliders(occ, bq, rq);
+            }
+            return checkers;
+        }
+        case MoveType::enpassant: {
+            // Two pawns leave the board so a discovered check can come through either square
+            const auto captured_bb = us == Side::White ? to_bb.south() : to_bb.north();
+            const auto occ = occupied() ^ from_bb ^ captured_bb ^ to_bb;
+            return (ci.check_squares[Piece::Pawn] & to_bb) | sliders(occ, bq, rq);
+        }
+        case MoveType::ksc:
+        case MoveType::qsc: {
+            const int i = move.type() == MoveType::ksc ? 0 : 1;
+            const auto king_to = castle_king_to[us * 2 + i];
+            const auto rook_to = i == 0 ? ksc_rook_to[us] : qsc_rook_to[us];
+            const auto occ = (occupied() ^ from_bb ^ to_bb) | Bitboard{king_to} | Bitboard{rook_to};
+            return sliders(occ, bq, (rq ^ to_bb) | Bitboard{rook_to});
+        }
+        default:
+            assert(false);
+            return Bitboard{};
+    }
+}
+
+[[nodiscard]] bool Position::gives_check(const Move &move) const noexcept {
+    return !checkers_after(move).empty();
+}
+
+}  // namespace libchess
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include "libchess/movegen.hpp"
+#include "libchess/position.hpp"
+#include "libchess/zobrist.hpp"
+
+namespace libchess {
+
+namespace {
+
+// Cuckoo tables of the hash difference made by every reversible non-pawn move on an empty board
+// Both directions of a move give the same key, so one entry covers a piece going there and back
+// See "Detecting repetitions" by Marcel van Kervinck for the idea
+
+constexpr int cuckoo_size = 8192;
+
+[[nodiscard]] constexpr int cuckoo_h1(const std::uint64_t key) noexcept {
+    return key & (cuckoo_size - 1);
+}
+
+[[nodiscard]] constexpr int cuckoo_h2(const std::uint64_t key) noexcept {
+    return (key >> 16) & (cuckoo_size - 1);
+}
+
+[[nodiscard]] constexpr std::uint64_t empty_board_ray(const int sq, const int df, const int dr) noexcept {
+    std::uint64_t result = 0;
+    for (int f = sq % 8 + df, r = sq / 8 + dr; 0 <= f && f <= 7 && 0 <= r && r <= 7; f += df, r += dr) {
+        result |= std::uint64_t{1} << (f + 8 * r);
+    }
+    return result;
+}
+
+[[nodiscard]] constexpr Bitboard empty_board_attacks(const Piece p, const int sq) noexcept {
+    const auto diagonal = empty_board_ray(sq, 1, 1) | empty_board_ray(sq, 1, -1) | empty_board_ray(sq, -1, 1) |
+                          empty_board_ray(sq, -1, -1);
+    const auto orthogonal = empty_board_ray(sq, 1, 0) | empty_board_ray(sq, -1, 0) | empty_board_ray(sq, 0, 1) |
+                            empty_board_ray(sq, 0, -1);
+    switch (p) {
+        case Piece::Knight:
+            return movegen::knight_masks[sq];
+        case Piece::Bishop:
+            return Bitboard{diagonal};
+        case Piece::Rook:
+            return Bitboard{orthogonal};
+        case Piece::Queen:
+            return Bitboard{diagonal | orthogonal};
+        case Piece::King:
+            return movegen::king_masks[sq];
+        case Piece::Pawn:
+        case Piece::None:
+        default:
+            return Bitboard{};
+    }
+}
+
+struct CuckooTables {
+    std::array<std::uint64_t, cuckoo_size> keys = {};
+    // Move squares, the lower numbered one first, as from | to << 8 with 0 marking an empty slot
+    std::array<std::uint16_t, cuckoo_size> squares = {};
+    int count = 0;
+};
+
+[[nodiscard]] constexpr CuckooTables generate_cuckoo_tables() noexcept {
+    CuckooTables tables;
+
+    for (const auto s : {Side::White, Side::Black}) {
+        for (const auto p : {Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen, Piece::King}) {
+            for (int a = 0; a < 64; ++a) {
+                for (int b = a + 1; b < 64; ++b) {
+                    if (!(empty_board_attacks(p, a) & Bitboard{Square{b}})) {
+                        continue;
+                    }
+
+                    auto key = zobrist::piece_key(p, s, Square{a}) ^ zobrist::piece_key(p, s, Square{b}) ^
+                               zobrist::turn_key();
+                    auto squares = static_cast<std::uint16_t>(a | b << 8);
+
+                    // Keep kicking out whatever is in the way to its other slot until an empty one turns up
+                    int i = cuckoo_h1(key);
+                    while (true) {
+                        std::swap(tables.keys[i], key);
+                        std::swap(tables.squares[i], squares);
+                        if (squares == 0) {
+                            break;
+                        }
+                        i = i == cuckoo_h1(key) ? cuckoo_h2(key) : cuckoo_h1(key);
+                    }
+                    tables.count++;
+                }
+            }
+        }
+    }
+
+    return tables;
+}
+
+constexpr auto cuckoo = generate_cuckoo_tables();
+
+static_assert(cuckoo.count == 3668);
+
+}  // namespace
+
+[[nodiscard]] bool Position::has_game_cycle(const int ply) const noexcept {
+    const auto n = history_.size();
+    const auto end = std::min(n, halfmoves());
+    if (end < 3) {
+        return false;
+    }
+
+    const auto occ = occupied();
+
+    // Only positions with the other side to move can be one of our moves away
+    for (std::size_t i = 3; i <= end; i += 2) {
+        const auto move_key = hash_ ^ history_[n - i].hash;
+
+        int j = cuckoo_h1(move_key);
+        if (cuckoo.keys[j] != move_key) {
+            j = cuckoo_h2(move_key);
+            if (cuckoo.keys[j] != move_key) {
+                continue;
+            }
+        }
+
+        const auto s1 = Square{cuckoo.squares[j] & 0xFF};
+        const auto s2 = Square{cuckoo.squares[j] >> 8};
+        if (squares_between(s1, s2) & occ) {
+            continue;
+        }
+
+        if (ply > static_cast<int>(i)) {
+            return true;
+        }
+
+        // Past the root the move has to be one of ours, and the position it reaches has to have repeated already
+        const auto sq = piece_on(s1) == Piece::None ? s2 : s1;
+        if (piece_on(sq) == Piece::None || owner_on(sq) != turn()) {
+            continue;
+        }
+
+        const auto k = n - i;
+        const auto window = std::min<std::size_t>(k, history_[k].halfmove_clock);
+        for (std::size_t m = 4; m <= window; m += 2) {
+            if (history_[k - m].hash == history_[k].hash) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+}  // namespace libchess
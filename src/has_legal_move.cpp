@@ -0,0 +1,117 @@
+#include <cassert>
+#include "libchess/movegen.hpp"
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+namespace {
+
+// Same rules as count_legal() but returns as soon as one legal move turns up
+// Pieces are tried roughly in order of how likely they are to have a move, castling last
+[[nodiscard]] bool any_legal(const Position &pos) noexcept {
+    const auto us = pos.turn();
+    const auto them = !us;
+    const auto ksq = pos.king_position(us);
+    const auto occ = pos.occupied();
+    const auto &st = pos.state();
+
+    // King
+    if (movegen::king_moves(ksq) & st.king_allowed) {
+        return true;
+    }
+
+    // If we're in check multiple times, only the king can move
+    if (st.checkers.count() > 1) {
+        return false;
+    }
+
+    const auto target = ~pos.occupancy(us) & ~pos.pieces(them, Piece::King) & st.check_mask;
+    const auto pinned_bishop = st.pinned_diagonal;
+    const auto pinned_rook = st.pinned_orthogonal;
+    const auto pinned = pinned_bishop | pinned_rook;
+
+    // Knights -- a pinned knight can never move
+    for (const auto &fr : pos.pieces(us, Piece::Knight) & ~pinned) {
+        if (movegen::knight_moves(fr) & target) {
+            return true;
+        }
+    }
+
+    // Pawns
+    {
+        const auto pawns = pos.pieces(us, Piece::Pawn);
+        const auto enemy = pos.occupancy(them) & target;
+        const auto double_rank = us == Side::White ? bitboards::Rank4 : bitboards::Rank5;
+        const auto forward = [us](const Bitboard bb) {
+            return us == Side::White ? bb.north() : bb.south();
+        };
+
+        const auto pushers = pawns & ~pinned_bishop & ~(pinned_rook & bitboards::ranks[ksq.rank()]);
+        const auto singles = forward(pushers) & pos.empty();
+        if ((singles & target) || (forward(singles) & pos.empty() & double_rank & target)) {
+            return true;
+        }
+
+        const auto free = pawns & ~pinned;
+        const auto diag = pawns & pinned_bishop;
+        if (((forward(free).east() | forward(free).west()) & enemy) ||
+            ((forward(diag).east() | forward(diag).west()) & st.diagonal_pin_rays & enemy)) {
+            return true;
+        }
+    }
+
+    // Sliders
+    for (const auto &fr : (pos.pieces(us, Piece::Bishop) | pos.pieces(us, Piece::Queen)) & ~pinned) {
+        if (movegen::bishop_moves(fr, occ) & target) {
+            return true;
+        }
+    }
+    for (const auto &fr : (pos.pieces(us, Piece::Rook) | pos.pieces(us, Piece::Queen)) & ~pinned) {
+        if (movegen::rook_moves(fr, occ) & target) {
+            return true;
+        }
+    }
+    for (const auto &fr : (pos.pieces(us, Piece::Bishop) | pos.pieces(us, Piece::Queen)) & pinned_bishop) {
+        if (movegen::bishop_moves(fr, occ) & target & st.diagonal_pin_rays) {
+            return true;
+        }
+    }
+    for (const auto &fr : (pos.pieces(us, Piece::Rook) | pos.pieces(us, Piece::Queen)) & pinned_rook) {
+        if (movegen::rook_moves(fr, occ) & target & st.orthogonal_pin_rays) {
+            return true;
+        }
+    }
+
+    // En passant and castling are rare enough to leave to the full check
+    if (pos.ep() != squares::OffSq) {
+        const auto ep_bb = Bitboard{pos.ep()};
+        const auto capturers = us == Side::White ? (ep_bb.south().east() | ep_bb.south().west())
+                                                 : (ep_bb.north().east() | ep_bb.north().west());
+        for (const auto &fr : capturers & pos.pieces(us, Piece::Pawn)) {
+            if (pos.is_legal(Move(MoveType::enpassant, fr, pos.ep(), Piece::Pawn, Piece::Pawn))) {
+                return true;
+            }
+        }
+    }
+
+    if (st.checkers.empty()) {
+        for (const auto type : {MoveType::ksc, MoveType::qsc}) {
+            if (pos.can_castle(us, type) &&
+                pos.is_legal(Move(type, ksq, pos.get_castling_square(us, type), Piece::King))) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+}  // namespace
+
+[[nodiscard]] bool Position::has_legal_move() const noexcept {
+    const auto found = any_legal(*this);
+    assert(found == !legal_moves().empty());
+    return found;
+}
+
+}  // namespace libchess
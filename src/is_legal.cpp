@@ -1,14 +1,188 @@
-#include <algorithm>
-#include <ranges>
+#include <cassert>
+#include "libchess/movegen.hpp"
 #include "libchess/position.hpp"
 
 namespace libchess {
 
 [[nodiscard]] bool Position::is_legal(const Move &m) const noexcept {
-    const auto moves = legal_moves();
-    return std::ranges::any_of(moves, [m](const auto &move) {
-        return move == m;
-    });
+    const auto legal = turn() == Side::White ? is_legal<Side::White>(m) : is_legal<Side::Black>(m);
+#ifndef NDEBUG
+    MoveList moves;
+    legal_moves(moves);
+    assert(legal == moves.contains(m));
+#endif
+    return legal;
+}
+
+// Checks the move directly rather than generating every legal move, the result is the same as
+// legal_moves() containing it, including the piece and captured piece stored in the move
+template <Side Us>
+[[nodiscard]] bool Position::is_legal(const Move &m) const noexcept {
+    constexpr auto them = !Us;
+    constexpr auto promo_rank = Us == Side::White ? bitboards::Rank8 : bitboards::Rank1;
+    constexpr auto double_rank = Us == Side::White ? bitboards::Rank4 : bitboards::Rank5;
+    const auto forward = [](const Bitboard bb) {
+        if constexpr (Us == Side::White) {
+            return bb.north();
+        } else {
+            return bb.south();
+        }
+    };
+
+    if (!m) {
+        return false;
+    }
+
+    const auto from = m.from();
+    const auto to = m.to();
+    const auto from_bb = Bitboard{from};
+    const auto to_bb = Bitboard{to};
+    const auto piece = m.piece();
+    const auto captured = m.captured();
+    const auto promo = m.promotion();
+    const auto occ = occupied();
+    const auto ksq = king_position(Us);
+
+    // The piece has to be ours and on the square
+    if (piece == Piece::None || piece_on(from) != piece || !(occupancy(Us) & from_bb)) {
+        return false;
+    }
+
+    // Piece moves, the destination square and move type are checked here, check and pins are left for later
+    const auto pawn_captures = forward(from_bb).east() | forward(from_bb).west();
+    switch (m.type()) {
+        case MoveType::Normal:
+            if (captured != Piece::None || promo != Piece::None || (occ & to_bb)) {
+                return false;
+            }
+            if (piece == Piece::Pawn && (forward(from_bb) != to_bb || (to_bb & promo_rank))) {
+                return false;
+            }
+            break;
+        case MoveType::Capture:
+            if (captured == Piece::None || captured == Piece::King || promo != Piece::None ||
+                !(occupancy(them) & to_bb) || piece_on(to) != captured) {
+                return false;
+            }
+            if (piece == Piece::Pawn && (!(pawn_captures & to_bb) || (to_bb & promo_rank))) {
+                return false;
+            }
+            break;
+        case MoveType::Double:
+            if (piece != Piece::Pawn || captured != Piece::None || promo != Piece::None) {
+                return false;
+            }
+            return forward(forward(from_bb)) == to_bb && (to_bb & double_rank) && !(occ & forward(from_bb)) &&
+                   !(occ & to_bb) && respects_check_and_pins(from, to);
+        case MoveType::promo:
+            if (piece != Piece::Pawn || captured != Piece::None || promo == Piece::Pawn || promo == Piece::King ||
+                promo == Piece::None || (occ & to_bb) || forward(from_bb) != to_bb || !(to_bb & promo_rank)) {
+                return false;
+            }
+            break;
+        case MoveType::promo_capture:
+            if (piece != Piece::Pawn || captured == Piece::None || captured == Piece::King || promo == Piece::Pawn ||
+                promo == Piece::King || promo == Piece::None || !(occupancy(them) & to_bb) ||
+                piece_on(to) != captured || !(pawn_captures & to_bb) || !(to_bb & promo_rank)) {
+                return false;
+            }
+            break;
+        case MoveType::enpassant: {
+            if (piece != Piece::Pawn || captured != Piece::Pawn || promo != Piece::None || ep_ != to ||
+                !(pawn_captures & to_bb)) {
+                return false;
+            }
+
+            // Easier to see if the king is attacked afterwards than to reason about checks and pins
+            const auto captured_bb = Us == Side::White ? to_bb.south() : to_bb.north();
+            const auto blockers = occ ^ from_bb ^ to_bb ^ captured_bb;
+            const auto bq = pieces(them, Piece::Bishop) | pieces(them, Piece::Queen);
+            const auto rq = pieces(them, Piece::Rook) | pieces(them, Piece::Queen);
+            const auto pawn_checks = forward(Bitboard{ksq}).east() | forward(Bitboard{ksq}).west();
+            const auto attacked = (movegen::bishop_moves(ksq, blockers) & bq) |
+                                  (movegen::rook_moves(ksq, blockers) & rq) |
+                                  (movegen::knight_moves(ksq) & pieces(them, Piece::Knight)) |
+                                  (pawn_checks & (pieces(them, Piece::Pawn) ^ captured_bb));
+            return attacked.empty();
+        }
+        case MoveType::ksc:
+        case MoveType::qsc: {
+            if (piece != Piece::King || captured != Piece::None || promo != Piece::None || !can_castle(Us, m.type())) {
+                return false;
+            }
+
+            const int i = m.type() == MoveType::ksc ? 0 : 1;
+            const auto rook_from = castle_rooks_from_[Us * 2 + i];
+            const auto king_to = castle_king_to[Us * 2 + i];
+            const auto rook_to = i == 0 ? ksc_rook_to[Us] : qsc_rook_to[Us];
+            if (to != rook_from || !state().checkers.empty()) {
+                return false;
+            }
+
+            const auto blockers = occ ^ from_bb ^ Bitboard(rook_from);
+            const auto king_path = (squares_between(from, king_to) | Bitboard(king_to)) & ~from_bb;
+            const auto rook_path = squares_between(rook_to, rook_from) | Bitboard(rook_to);
+            if ((king_path & blockers) || (rook_path & blockers) || (state().pinned_orthogonal & rook_from)) {
+                return false;
+            }
+            return !(squares_attacked<them>() & king_path);
+        }
+        default:
+            return false;
+    }
+
+    // The king only has to avoid attacked squares
+    if (piece == Piece::King) {
+        return bool(movegen::king_moves(from) & state().king_allowed & to_bb);
+    }
+
+    // Everything else needs a clear path
+    switch (piece) {
+        case Piece::Pawn:
+            break;
+        case Piece::Knight:
+            if (!(movegen::knight_moves(from) & to_bb)) {
+                return false;
+            }
+            break;
+        case Piece::Bishop:
+            if (!(movegen::bishop_moves(from, occ) & to_bb)) {
+                return false;
+            }
+            break;
+        case Piece::Rook:
+            if (!(movegen::rook_moves(from, occ) & to_bb)) {
+                return false;
+            }
+            break;
+        case Piece::Queen:
+            if (!(movegen::queen_moves(from, occ) & to_bb)) {
+                return false;
+            }
+            break;
+        case Piece::King:
+        case Piece::None:
+        default:
+            return false;
+    }
+
+    return respects_check_and_pins(from, to);
+}
+
+// A non-king move has to resolve any check and can't leave a pin line
+[[nodiscard]] bool Position::respects_check_and_pins(const Square from, const Square to) const noexcept {
+    const auto &st = state();
+    const auto ksq = king_position(turn());
+
+    if (!(st.check_mask & Bitboard{to})) {
+        return false;
+    }
+
+    if ((st.pinned_diagonal | st.pinned_orthogonal) & Bitboard{from}) {
+        return bool((squares_between(ksq, to) & Bitboard{from}) || (squares_between(ksq, from) & Bitboard{to}));
+    }
+
+    return true;
 }
 
 }  // namespace libchess
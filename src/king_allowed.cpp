@@ -4,54 +4,69 @@
 namespace libchess {
 
 [[nodiscard]] Bitboard Position::king_allowed() const noexcept {
-    return king_allowed(turn());
+    return state().king_allowed;
 }
 
 [[nodiscard]] Bitboard Position::king_allowed(const Side s) const noexcept {
-    const Bitboard blockers = ~empty() ^ king_position(s);
+    if (s == turn()) {
+        return king_allowed();
+    } else if (s == Side::White) {
+        return king_allowed<Side::White>();
+    } else {
+        return king_allowed<Side::Black>();
+    }
+}
+
+template <Side S>
+[[nodiscard]] Bitboard Position::king_allowed() const noexcept {
+    constexpr auto them = !S;
+    const Bitboard blockers = ~empty() ^ king_position(S);
     Bitboard mask;
 
     // Pawns
-    if (s == Side::White) {
-        const auto pawns = pieces(!s, Piece::Pawn);
+    if constexpr (S == Side::White) {
+        const auto pawns = pieces(them, Piece::Pawn);
         mask |= pawns.south().east();
         mask |= pawns.south().west();
     } else {
-        const auto pawns = pieces(!s, Piece::Pawn);
+        const auto pawns = pieces(them, Piece::Pawn);
         mask |= pawns.north().east();
         mask |= pawns.north().west();
     }
 
     // Knights
-    for (const auto &fr : pieces(!s, Piece::Knight)) {
+    for (const auto &fr : pieces(them, Piece::Knight)) {
         mask |= movegen::knight_moves(fr);
     }
 
     // Bishops
-    for (const auto &fr : pieces(!s, Piece::Bishop)) {
+    for (const auto &fr : pieces(them, Piece::Bishop)) {
         mask |= movegen::bishop_moves(fr, blockers);
     }
 
     // Rooks
-    for (const auto &fr : pieces(!s, Piece::Rook)) {
+    for (const auto &fr : pieces(them, Piece::Rook)) {
         mask |= movegen::rook_moves(fr, blockers);
     }
 
     // Queens
-    for (const auto &fr : pieces(!s, Piece::Queen)) {
+    for (const auto &fr : pieces(them, Piece::Queen)) {
         mask |= movegen::queen_moves(fr, blockers);
     }
 
     // King
-    mask |= movegen::king_moves(king_position(!s));
+    mask |= movegen::king_moves(king_position(them));
 
     // Let's remove friendly pieces
-    mask |= occupancy(s);
+    mask |= occupancy(S);
 
     // Let's remove enemy king square
-    mask |= king_position(!s);
+    mask |= king_position(them);
 
     return ~mask;
 }
 
+template Bitboard Position::king_allowed<Side::White>() const noexcept;
+template Bitboard Position::king_allowed<Side::Black>() const noexcept;
+
 }  // namespace libchess
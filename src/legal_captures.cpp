@@ -14,16 +14,36 @@ namespace libchess {
 }
 
 void Position::legal_captures(std::vector<Move> &moves) const noexcept {
+    if (turn() == Side::White) {
+        generate_captures<Side::White>(moves);
+    } else {
+        generate_captures<Side::Black>(moves);
+    }
+}
+
+void Position::legal_captures(MoveList &moves) const noexcept {
+    if (turn() == Side::White) {
+        generate_captures<Side::White>(moves);
+    } else {
+        generate_captures<Side::Black>(moves);
+    }
+}
+
+template <Side Us, typename T>
+void Position::generate_captures(T &moves) const noexcept {
+    assert(turn() == Us);
     [[maybe_unused]] const auto start_size = moves.size();
-    const auto us = turn();
-    const auto them = !us;
-    const auto ksq = king_position(us);
-    const auto checkers = this->checkers();
+    constexpr auto them = !Us;
+    constexpr auto promo_rank = Us == Side::White ? bitboards::Rank7 : bitboards::Rank2;
+    const auto ksq = king_position(Us);
+    const auto &st = state();
+    const auto checkers = st.checkers;
     const auto ep_bb = ep_ == squares::OffSq ? Bitboard{} : Bitboard{ep_};
-    auto allowed = occupancy(them);
+    const auto allowed = occupancy(them) & st.check_mask;
+    const auto evasion_squares = st.check_mask & ~checkers;
 
     if (checkers.count() > 1) {
-        const auto mask = movegen::king_moves(ksq) & king_allowed() & occupancy(them);
+        const auto mask = movegen::king_moves(ksq) & st.king_allowed & occupancy(them);
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
             assert(cap != Piece::None);
@@ -31,10 +51,31 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
             moves.emplace_back(MoveType::Capture, ksq, to, Piece::King, cap);
         }
         return;
-    } else if (checkers.count() == 1) {
-        allowed = Bitboard{checkers.lsb()};
     }
 
+    // Pawn directions relative to the side to move
+    const auto forward = [](const Bitboard bb) {
+        if constexpr (Us == Side::White) {
+            return bb.north();
+        } else {
+            return bb.south();
+        }
+    };
+    const auto backward = [](const Bitboard bb) {
+        if constexpr (Us == Side::White) {
+            return bb.south();
+        } else {
+            return bb.north();
+        }
+    };
+    const auto back = [](const Square sq) {
+        if constexpr (Us == Side::White) {
+            return sq.south();
+        } else {
+            return sq.north();
+        }
+    };
+
     const auto ray_north_east = [](const Square sq, const Bitboard blockers) {
         auto bb = Bitboard(sq).north().east();
         bb |= (bb & ~blockers).north().east();
@@ -79,170 +120,97 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
         return bb;
     };
 
-    const auto kfile = bitboards::files[ksq.file()];
-    const auto krank = bitboards::ranks[ksq.rank()];
-    const auto pinned = this->pinned();
-    const auto pinned_horizontal = pinned & krank;
-    const auto pinned_vertical = pinned & kfile;
-    const auto pinned_rook = pinned_horizontal | pinned_vertical;
-    const auto pinned_bishop = pinned ^ pinned_rook;
+    const auto pinned_rook = st.pinned_orthogonal;
+    const auto pinned_bishop = st.pinned_diagonal;
+    const auto pinned = pinned_rook | pinned_bishop;
     const auto pinned_ne_sw = pinned_bishop & (ray_north_east(ksq, occupied()) | ray_south_west(ksq, occupied()));
     const auto pinned_nw_se = pinned_bishop ^ pinned_ne_sw;
 
-    const auto bishop_xrays = movegen::bishop_moves(ksq, occupied() ^ pinned_bishop);
-    const auto rook_xrays = movegen::rook_moves(ksq, occupied() ^ pinned_rook);
+    // Pinned pawns may only capture along the diagonal they're pinned on
+    // Going forward east is north east for white and south east for black
+    constexpr bool east_is_ne = Us == Side::White;
+    const auto pinned_east = east_is_ne ? pinned_nw_se : pinned_ne_sw;
+    const auto pinned_west = east_is_ne ? pinned_ne_sw : pinned_nw_se;
+
+    const auto bishop_xrays = st.diagonal_pin_rays;
+    const auto rook_xrays = st.orthogonal_pin_rays;
 
     assert((pinned_ne_sw | pinned_nw_se) == pinned_bishop);
-    assert((pinned_vertical | pinned_horizontal) == pinned_rook);
-    assert((pinned_bishop | pinned_rook) == pinned);
 
     // Pawns
-    if (us == Side::White) {
-        const auto pawns_ne = pieces(us, Piece::Pawn) & ~pinned_rook & ~pinned_nw_se;
-        const auto pawns_nw = pieces(us, Piece::Pawn) & ~pinned_rook & ~pinned_ne_sw;
-        const auto promo_ne = pawns_ne & bitboards::Rank7;
-        const auto promo_nw = pawns_nw & bitboards::Rank7;
-        const auto nonpromo_ne = pawns_ne & ~bitboards::Rank7;
-        const auto nonpromo_nw = pawns_nw & ~bitboards::Rank7;
-
-        // Captures -- North east
-        for (const auto &sq : nonpromo_ne.north().east() & allowed) {
-            const auto cap = piece_on(sq);
-            assert(cap != Piece::None);
-            assert(cap != Piece::King);
-            moves.emplace_back(MoveType::Capture, sq.south().west(), sq, Piece::Pawn, cap);
-        }
-
-        // Captures -- North west
-        for (const auto &sq : nonpromo_nw.north().west() & allowed) {
-            const auto cap = piece_on(sq);
-            assert(cap != Piece::None);
-            assert(cap != Piece::King);
-            moves.emplace_back(MoveType::Capture, sq.south().east(), sq, Piece::Pawn, cap);
-        }
-
-        // Promo Captures -- North east
-        for (const auto &sq : promo_ne.north().east() & allowed) {
-            const auto cap = piece_on(sq);
-            assert(cap != Piece::None);
-            assert(cap != Piece::King);
-            moves.emplace_back(MoveType::promo_capture, sq.south().west(), sq, Piece::Pawn, cap, Piece::Queen);
-            moves.emplace_back(MoveType::promo_capture, sq.south().west(), sq, Piece::Pawn, cap, Piece::Rook);
-            moves.emplace_back(MoveType::promo_capture, sq.south().west(), sq, Piece::Pawn, cap, Piece::Bishop);
-            moves.emplace_back(MoveType::promo_capture, sq.south().west(), sq, Piece::Pawn, cap, Piece::Knight);
-        }
-
-        // Promo Captures -- North west
-        for (const auto &sq : promo_nw.north().west() & allowed) {
-            const auto cap = piece_on(sq);
-            assert(cap != Piece::None);
-            assert(cap != Piece::King);
-            moves.emplace_back(MoveType::promo_capture, sq.south().east(), sq, Piece::Pawn, cap, Piece::Queen);
-            moves.emplace_back(MoveType::promo_capture, sq.south().east(), sq, Piece::Pawn, cap, Piece::Rook);
-            moves.emplace_back(MoveType::promo_capture, sq.south().east(), sq, Piece::Pawn, cap, Piece::Bishop);
-            moves.emplace_back(MoveType::promo_capture, sq.south().east(), sq, Piece::Pawn, cap, Piece::Knight);
-        }
-
-        // En passant
-        if (ep_bb) {
-            const auto rq = pieces(Side::Black, Piece::Rook) | pieces(Side::Black, Piece::Queen);
-
-            // North west
-            if (pawns_nw & ep_bb.south().east()) {
-                const auto blockers = occupied() ^ ep_bb ^ ep_bb.south() ^ ep_bb.south().east();
-                const auto east = ray_east(ksq, blockers);
-                const auto west = ray_west(ksq, blockers);
-                if (east & rq || west & rq) {
-                } else {
-                    moves.emplace_back(MoveType::enpassant, ep_.south().east(), ep_, Piece::Pawn, Piece::Pawn);
-                }
-            }
-            // North east
-            if (pawns_ne & ep_bb.south().west()) {
-                const auto blockers = occupied() ^ ep_bb ^ ep_bb.south() ^ ep_bb.south().west();
-                const auto east = ray_east(ksq, blockers);
-                const auto west = ray_west(ksq, blockers);
-                if (east & rq || west & rq) {
-                } else {
-                    moves.emplace_back(MoveType::enpassant, ep_.south().west(), ep_, Piece::Pawn, Piece::Pawn);
-                }
-            }
-        }
-    } else {
-        const auto pawns_se = pieces(us, Piece::Pawn) & ~pinned_rook & ~pinned_ne_sw;
-        const auto pawns_sw = pieces(us, Piece::Pawn) & ~pinned_rook & ~pinned_nw_se;
-        const auto promo_se = pawns_se & bitboards::Rank2;
-        const auto promo_sw = pawns_sw & bitboards::Rank2;
-        const auto nonpromo_se = pawns_se & ~bitboards::Rank2;
-        const auto nonpromo_sw = pawns_sw & ~bitboards::Rank2;
+    {
+        const auto pawns_east = pieces(Us, Piece::Pawn) & ~pinned_rook & ~pinned_east;
+        const auto pawns_west = pieces(Us, Piece::Pawn) & ~pinned_rook & ~pinned_west;
+        const auto promo_east = pawns_east & promo_rank;
+        const auto promo_west = pawns_west & promo_rank;
+        const auto nonpromo_east = pawns_east & ~promo_rank;
+        const auto nonpromo_west = pawns_west & ~promo_rank;
 
-        // Captures -- South east
-        for (const auto &sq : nonpromo_se.south().east() & allowed) {
+        // Captures -- Forward east
+        for (const auto &sq : forward(nonpromo_east).east() & allowed) {
             const auto cap = piece_on(sq);
             assert(cap != Piece::None);
             assert(cap != Piece::King);
-            moves.emplace_back(MoveType::Capture, sq.north().west(), sq, Piece::Pawn, cap);
+            moves.emplace_back(MoveType::Capture, back(sq).west(), sq, Piece::Pawn, cap);
         }
 
-        // Captures -- South west
-        for (const auto &sq : nonpromo_sw.south().west() & allowed) {
+        // Captures -- Forward west
+        for (const auto &sq : forward(nonpromo_west).west() & allowed) {
             const auto cap = piece_on(sq);
             assert(cap != Piece::None);
             assert(cap != Piece::King);
-            moves.emplace_back(MoveType::Capture, sq.north().east(), sq, Piece::Pawn, cap);
+            moves.emplace_back(MoveType::Capture, back(sq).east(), sq, Piece::Pawn, cap);
         }
 
-        // Promo Captures -- South east
-        for (const auto &sq : promo_se.south().east() & allowed) {
+        // Promo Captures -- Forward east
+        for (const auto &sq : forward(promo_east).east() & allowed) {
             const auto cap = piece_on(sq);
             assert(cap != Piece::None);
             assert(cap != Piece::King);
-            moves.emplace_back(MoveType::promo_capture, sq.north().west(), sq, Piece::Pawn, cap, Piece::Queen);
-            moves.emplace_back(MoveType::promo_capture, sq.north().west(), sq, Piece::Pawn, cap, Piece::Rook);
-            moves.emplace_back(MoveType::promo_capture, sq.north().west(), sq, Piece::Pawn, cap, Piece::Bishop);
-            moves.emplace_back(MoveType::promo_capture, sq.north().west(), sq, Piece::Pawn, cap, Piece::Knight);
+            moves.emplace_back(MoveType::promo_capture, back(sq).west(), sq, Piece::Pawn, cap, Piece::Queen);
+            moves.emplace_back(MoveType::promo_capture, back(sq).west(), sq, Piece::Pawn, cap, Piece::Rook);
+            moves.emplace_back(MoveType::promo_capture, back(sq).west(), sq, Piece::Pawn, cap, Piece::Bishop);
+            moves.emplace_back(MoveType::promo_capture, back(sq).west(), sq, Piece::Pawn, cap, Piece::Knight);
         }
 
-        // Promo Captures -- South west
-        for (const auto &sq : promo_sw.south().west() & allowed) {
+        // Promo Captures -- Forward west
+        for (const auto &sq : forward(promo_west).west() & allowed) {
             const auto cap = piece_on(sq);
             assert(cap != Piece::None);
             assert(cap != Piece::King);
-            moves.emplace_back(MoveType::promo_capture, sq.north().east(), sq, Piece::Pawn, cap, Piece::Queen);
-            moves.emplace_back(MoveType::promo_capture, sq.north().east(), sq, Piece::Pawn, cap, Piece::Rook);
-            moves.emplace_back(MoveType::promo_capture, sq.north().east(), sq, Piece::Pawn, cap, Piece::Bishop);
-            moves.emplace_back(MoveType::promo_capture, sq.north().east(), sq, Piece::Pawn, cap, Piece::Knight);
+            moves.emplace_back(MoveType::promo_capture, back(sq).east(), sq, Piece::Pawn, cap, Piece::Queen);
+            moves.emplace_back(MoveType::promo_capture, back(sq).east(), sq, Piece::Pawn, cap, Piece::Rook);
+            moves.emplace_back(MoveType::promo_capture, back(sq).east(), sq, Piece::Pawn, cap, Piece::Bishop);
+            moves.emplace_back(MoveType::promo_capture, back(sq).east(), sq, Piece::Pawn, cap, Piece::Knight);
         }
 
-        // En passant
-        if (ep_bb) {
-            const auto rq = pieces(Side::White, Piece::Rook) | pieces(Side::White, Piece::Queen);
+        // En passant -- when in check it has to capture the checker or block the check
+        if (ep_bb && (checkers.empty() || (checkers & backward(ep_bb)) || (evasion_squares & ep_bb))) {
+            const auto rq = pieces(them, Piece::Rook) | pieces(them, Piece::Queen);
 
-            // South west
-            if (nonpromo_sw & ep_bb.north().east() & ~pinned_nw_se) {
-                const auto blockers = occupied() ^ ep_bb.north() ^ ep_bb.north().east();
+            // Forward west
+            if (pawns_west & backward(ep_bb).east()) {
+                const auto blockers = occupied() ^ ep_bb ^ backward(ep_bb) ^ backward(ep_bb).east();
                 const auto east = ray_east(ksq, blockers);
                 const auto west = ray_west(ksq, blockers);
-                if (east & rq || west & rq) {
-                } else {
-                    moves.emplace_back(MoveType::enpassant, ep_.north().east(), ep_, Piece::Pawn, Piece::Pawn);
+                if (!(east & rq) && !(west & rq)) {
+                    moves.emplace_back(MoveType::enpassant, back(ep_).east(), ep_, Piece::Pawn, Piece::Pawn);
                 }
             }
-            // South east
-            if (nonpromo_se & ep_bb.north().west() & ~pinned_ne_sw) {
-                const auto blockers = occupied() ^ ep_bb.north() ^ ep_bb.north().west();
+            // Forward east
+            if (pawns_east & backward(ep_bb).west()) {
+                const auto blockers = occupied() ^ ep_bb ^ backward(ep_bb) ^ backward(ep_bb).west();
                 const auto east = ray_east(ksq, blockers);
                 const auto west = ray_west(ksq, blockers);
-                if (east & rq || west & rq) {
-                } else {
-                    moves.emplace_back(MoveType::enpassant, ep_.north().west(), ep_, Piece::Pawn, Piece::Pawn);
+                if (!(east & rq) && !(west & rq)) {
+                    moves.emplace_back(MoveType::enpassant, back(ep_).west(), ep_, Piece::Pawn, Piece::Pawn);
                 }
             }
         }
     }
 
     // Knights
-    for (const auto &fr : pieces(us, Piece::Knight) & ~pinned) {
+    for (const auto &fr : pieces(Us, Piece::Knight) & ~pinned) {
         const auto mask = movegen::knight_moves(fr) & allowed;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -253,7 +221,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
     }
 
     // Bishops -- nonpinned
-    for (const auto &fr : pieces(us, Piece::Bishop) & ~pinned) {
+    for (const auto &fr : pieces(Us, Piece::Bishop) & ~pinned) {
         const auto mask = movegen::bishop_moves(fr, ~empty()) & allowed;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -263,7 +231,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
         }
     }
     // Bishops -- pinned
-    for (const auto &fr : pieces(us, Piece::Bishop) & pinned_bishop) {
+    for (const auto &fr : pieces(Us, Piece::Bishop) & pinned_bishop) {
         const auto mask = movegen::bishop_moves(fr, ~empty()) & allowed & bishop_xrays;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -274,7 +242,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
     }
 
     // Rooks -- nonpinned
-    for (const auto &fr : pieces(us, Piece::Rook) & ~pinned) {
+    for (const auto &fr : pieces(Us, Piece::Rook) & ~pinned) {
         const auto mask = movegen::rook_moves(fr, ~empty()) & allowed;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -284,7 +252,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
         }
     }
     // Rooks -- pinned
-    for (const auto &fr : pieces(us, Piece::Rook) & pinned_rook) {
+    for (const auto &fr : pieces(Us, Piece::Rook) & pinned_rook) {
         const auto mask = movegen::rook_moves(fr, ~empty()) & allowed & rook_xrays;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -295,7 +263,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
     }
 
     // Queens -- queen moves -- nonpinned
-    for (const auto &fr : pieces(us, Piece::Queen) & ~pinned) {
+    for (const auto &fr : pieces(Us, Piece::Queen) & ~pinned) {
         const auto mask = movegen::queen_moves(fr, ~empty()) & allowed;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -305,7 +273,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
         }
     }
     // Queens -- bishop moves -- bishop pinned
-    for (const auto &fr : pieces(us, Piece::Queen) & pinned_bishop) {
+    for (const auto &fr : pieces(Us, Piece::Queen) & pinned_bishop) {
         const auto mask = movegen::bishop_moves(fr, ~empty()) & allowed & bishop_xrays;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -315,7 +283,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
         }
     }
     // Queens -- rook moves -- rook pinned
-    for (const auto &fr : pieces(us, Piece::Queen) & pinned_rook) {
+    for (const auto &fr : pieces(Us, Piece::Queen) & pinned_rook) {
         const auto mask = movegen::rook_moves(fr, ~empty()) & allowed & rook_xrays;
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
@@ -327,7 +295,7 @@ void Position::legal_captures(std::vector<Move> &moves) const noexcept {
 
     // King
     {
-        const auto mask = movegen::king_moves(ksq) & king_allowed() & occupancy(them);
+        const auto mask = movegen::king_moves(ksq) & st.king_allowed & occupancy(them);
         for (const auto &to : mask) {
             const auto cap = piece_on(to);
             assert(cap != Piece::None);
@@ -15,4 +15,9 @@ void Position::legal_moves(std::vector<Move> &moves) const noexcept {
     legal_noncaptures(moves);
 }
 
+void Position::legal_moves(MoveList &moves) const noexcept {
+    legal_captures(moves);
+    legal_noncaptures(moves);
+}
+
 }  // namespace libchess
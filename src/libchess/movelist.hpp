@@ -0,0 +1,111 @@
+#ifndef LIBCHESS_MOVELIST_HPP
+#define LIBCHESS_MOVELIST_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include "move.hpp"
+
+namespace libchess {
+
+// Fixed capacity move container that lives on the stack
+// 256 is comfortably above the maximum number of legal moves in any position (218)
+class MoveList {
+   public:
+    using value_type = Move;
+    using size_type = std::size_t;
+    using iterator = Move *;
+    using const_iterator = const Move *;
+
+    static constexpr std::size_t capacity = 256;
+
+    // The storage is deliberately left uninitialised, only [0, size) is ever read
+    [[nodiscard]] MoveList() noexcept {
+    }
+
+    constexpr void push_back(const Move &move) noexcept {
+        assert(size_ < capacity);
+        moves_[size_++] = move;
+    }
+
+    template <typename... Args>
+    constexpr Move &emplace_back(Args &&...args) noexcept {
+        assert(size_ < capacity);
+        moves_[size_] = Move(std::forward<Args>(args)...);
+        return moves_[size_++];
+    }
+
+    constexpr void pop_back() noexcept {
+        assert(size_ > 0);
+        size_--;
+    }
+
+    constexpr void clear() noexcept {
+        size_ = 0;
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] constexpr Move &operator[](const std::size_t idx) noexcept {
+        assert(idx < size_);
+        return moves_[idx];
+    }
+
+    [[nodiscard]] constexpr const Move &operator[](const std::size_t idx) const noexcept {
+        assert(idx < size_);
+        return moves_[idx];
+    }
+
+    [[nodiscard]] constexpr Move &back() noexcept {
+        assert(size_ > 0);
+        return moves_[size_ - 1];
+    }
+
+    [[nodiscard]] constexpr const Move &back() const noexcept {
+        assert(size_ > 0);
+        return moves_[size_ - 1];
+    }
+
+    [[nodiscard]] constexpr iterator begin() noexcept {
+        return moves_;
+    }
+
+    [[nodiscard]] constexpr iterator end() noexcept {
+        return moves_ + size_;
+    }
+
+    [[nodiscard]] constexpr const_iterator begin() const noexcept {
+        return moves_;
+    }
+
+    [[nodiscard]] constexpr const_iterator end() const noexcept {
+        return moves_ + size_;
+    }
+
+    [[nodiscard]] constexpr bool contains(const Move &move) const noexcept {
+        for (const auto &m : *this) {
+            if (m == move) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+   private:
+    union {
+        Move moves_[capacity];
+    };
+    std::size_t size_ = 0;
+};
+
+static_assert(MoveList::capacity >= 218);
+
+}  // namespace libchess
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef LIBCHESS_MOVEPICKER_HPP
+#define LIBCHESS_MOVEPICKER_HPP
+
+#include <array>
+#include "move.hpp"
+#include "movelist.hpp"
+#include "position.hpp"
+
+namespace libchess {
+
+// Hands out the legal moves of a position one at a time, only generating each stage when it's reached:
+// hash move, captures (most valuable victim first), killers and counter move, then the remaining quiets
+// Moves that don't belong to the position (e.g. a stale hash move or killer) are ignored and nothing is returned twice
+// The position must not change while the picker is in use
+class MovePicker {
+   public:
+    enum class Stage : int
+    {
+        HashMove = 0,
+        GenerateCaptures,
+        Captures,
+        Killer1,
+        Killer2,
+        Counter,
+        GenerateQuiets,
+        Quiets,
+        Done,
+    };
+
+    [[nodiscard]] MovePicker(const Position &pos,
+                             const Move hash_move = {},
+                             const Move killer1 = {},
+                             const Move killer2 = {},
+                             const Move counter = {}) noexcept
+        : pos_{pos}, hash_move_{hash_move}, refutations_{{killer1, killer2, counter}} {
+    }
+
+    // Fetch the next move, returns false once every move has been handed out
+    [[nodiscard]] bool next(Move &move) noexcept;
+
+    // Stop before the killer and quiet stages, e.g. for quiescence search
+    constexpr void skip_quiets() noexcept {
+        skip_quiets_ = true;
+    }
+
+    [[nodiscard]] constexpr Stage stage() const noexcept {
+        return stage_;
+    }
+
+   private:
+    [[nodiscard]] bool refutation(const Move &move) const noexcept;
+
+    const Position &pos_;
+    Move hash_move_;
+    // Killer 1, killer 2, counter move
+    std::array<Move, 3> refutations_;
+    Stage stage_ = Stage::HashMove;
+    bool skip_quiets_ = false;
+    MoveList moves_;
+    std::size_t idx_ = 0;
+    // Capture scores, only the first moves_.size() are used
+    std::array<int, MoveList::capacity> scores_;
+};
+
+}  // namespace libchess
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef LIBCHESS_PACKED_POSITION_HPP
+#define LIBCHESS_PACKED_POSITION_HPP
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace libchess {
+
+// Fixed size binary form of a Position, made by Position::pack() and read back with Position::unpack()
+// Plain data in host byte order, so it can be written to disk, memory mapped or copied between processes as is
+struct PackedPosition {
+    // Occupied squares
+    std::uint64_t occupied;
+    // One nibble per occupied square in ascending square order, low nibble first, the colour in bit 3 and the piece
+    // type below it
+    std::array<std::uint8_t, 16> pieces;
+    // Bits 0-3 are the castling rights in the order white ksc, white qsc, black ksc, black qsc,
+    // followed by the file of each castling rook, 3 bits each and in the same order
+    std::uint16_t castling;
+    // Capped at 65535
+    std::uint16_t halfmoves;
+    // Bit 0 is set with black to move, bits 1-7 are the en passant square or 64 for none,
+    // the rest is the fullmove number capped at 2^24 - 1
+    std::uint32_t state;
+};
+
+static_assert(sizeof(PackedPosition) == 32);
+static_assert(std::is_trivially_copyable_v<PackedPosition>);
+
+}  // namespace libchess
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef LIBCHESS_PERFT_HPP
+#define LIBCHESS_PERFT_HPP
+
+#include <cstdint>
+#include "position.hpp"
+
+namespace libchess {
+
+// Same count as Position::perft() but spread over several threads
+// The tree is split a few plies deep into tasks, each thread works on its own copy of the position and takes tasks
+// from its own queue first, stealing from the others once that runs dry
+[[nodiscard]] std::uint64_t perft_parallel(const Position &pos, const int depth, const int threads);
+
+}  // namespace libchess
+
+#endif
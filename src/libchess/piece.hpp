@@ -25,6 +25,9 @@ inline constexpr std::array<Piece, 6> pieces = {{
     Piece::King,
 }};
 
+// Nominal piece values in centipawns, indexed by Piece
+inline constexpr std::array<int, 7> piece_values = {{100, 300, 300, 500, 900, 0, 0}};
+
 }  // namespace libchess
 
 #endif
@@ -1,28 +1,32 @@
 #ifndef LIBCHESS_POSITION_HPP
 #define LIBCHESS_POSITION_HPP
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "bitboard.hpp"
 #include "move.hpp"
+#include "movelist.hpp"
+#include "packed_position.hpp"
 #include "piece.hpp"
 #include "side.hpp"
 #include "zobrist.hpp"
 
+// Number of plies the undo history reserves on the first move, makemove() still works past it but may reallocate
+#ifndef LIBCHESS_MAX_PLY
+#define LIBCHESS_MAX_PLY 1024
+#endif
+
 namespace libchess {
 
 namespace {
 
-enum Castling : int
-{
-    usKSC,
-    usQSC,
-    themKSC,
-    themQSC
-};
-
 constexpr const Square ksc_rook_to[] = {squares::F1, squares::F8};
 constexpr const Square qsc_rook_to[] = {squares::D1, squares::D8};
 constexpr const Square castle_king_to[] = {squares::G1, squares::C1, squares::G8, squares::C8};
@@ -31,12 +35,90 @@ constexpr const Square castle_king_to[] = {squares::G1, squares::C1, squares::G8
 
 class Position {
    public:
+    // Check and pin information for one side, everything the legal move generators need to know about the king
+    struct StateInfo {
+        // Enemy pieces giving check
+        Bitboard checkers;
+        // Friendly pieces pinned to the king along a diagonal
+        Bitboard pinned_diagonal;
+        // Friendly pieces pinned to the king along a rank or file
+        Bitboard pinned_orthogonal;
+        // Bishop rays from the king looking through diagonally pinned pieces, pinned pieces stay on these
+        Bitboard diagonal_pin_rays;
+        // Rook rays from the king looking through orthogonally pinned pieces
+        Bitboard orthogonal_pin_rays;
+        // Squares a non-king move has to land on, every square if not in check and none if in double check
+        Bitboard check_mask;
+        // Squares the king can move to without being attacked, excluding friendly pieces
+        Bitboard king_allowed;
+    };
+
+    // What the side to move needs to know to spot a checking move without making it
+    struct CheckInfo {
+        // Squares each of our piece types would attack the enemy king from, indexed by Piece
+        std::array<Bitboard, 6> check_squares;
+        // Our pieces standing between one of our sliders and the enemy king, moving them off the line gives check
+        Bitboard discoverers;
+    };
+
+    enum class Status : int
+    {
+        Ongoing = 0,
+        Checkmate,
+        Stalemate,
+        FiftyMoves,
+        Threefold,
+        InsufficientMaterial,
+    };
+
+    // Why try_set_fen() rejected a FEN, offset is where in the string the problem was found
+    struct FenError {
+        enum class Field : int
+        {
+            None = 0,
+            Board,
+            Turn,
+            Castling,
+            EnPassant,
+            Halfmove,
+            Fullmove,
+            Trailing,
+        };
+
+        Field field = Field::None;
+        std::size_t offset = 0;
+        std::string_view reason;
+
+        // True if there was an error
+        [[nodiscard]] constexpr explicit operator bool() const noexcept {
+            return field != Field::None;
+        }
+    };
+
     [[nodiscard]] Position() = default;
 
+    // Throws std::invalid_argument if the FEN is malformed
     [[nodiscard]] explicit Position(const std::string &fen, const bool dfrc = false) {
-        set_fen(fen, dfrc);
+        const auto error = try_set_fen(fen, dfrc);
+        if (error) {
+            throw std::invalid_argument("Invalid FEN: " + std::string(error.reason));
+        }
     }
 
+    // Throws std::invalid_argument if the packed position isn't valid
+    [[nodiscard]] explicit Position(const PackedPosition &packed) {
+        if (!unpack(packed)) {
+            throw std::invalid_argument("Invalid PackedPosition");
+        }
+    }
+
+    // Copies allocate for the undo history anyway, so they're out of line rather than inlined at every call site
+    Position(const Position &other);
+    Position(Position &&other) noexcept = default;
+    Position &operator=(const Position &other);
+    Position &operator=(Position &&other) noexcept = default;
+    ~Position() = default;
+
     [[nodiscard]] constexpr Side turn() const noexcept {
         return to_move_;
     }
@@ -65,35 +147,84 @@ class Position {
         return hash_;
     }
 
+    // Zobrist key of the pawns alone, for pawn structure caches
+    [[nodiscard]] constexpr std::uint64_t pawn_hash() const noexcept {
+        return pawn_hash_;
+    }
+
+    // Zobrist key of the piece counts per side, positions with the same material share it
+    [[nodiscard]] constexpr std::uint64_t material_hash() const noexcept {
+        return material_hash_;
+    }
+
+    // Sum of piece_values over knights, bishops, rooks and queens
+    [[nodiscard]] constexpr int non_pawn_material(const Side s) const noexcept {
+        return non_pawn_material_[s];
+    }
+
+    [[nodiscard]] constexpr int piece_count(const Side s, const Piece p) const noexcept {
+        return pieces(s, p).count();
+    }
+
+    // A malformed FEN leaves the position unchanged, try_set_fen() says what was wrong with it
     void set_fen(const std::string &fen, const bool dfrc = false) noexcept;
 
+    // Parses the FEN without allocating, the move counters are optional and "startpos" is accepted
+    [[nodiscard]] FenError try_set_fen(const std::string_view fen, const bool dfrc = false) noexcept;
+
     [[nodiscard]] std::string get_fen(const bool dfrc = false) const noexcept;
 
+    // Longest FEN write_fen() can produce
+    static constexpr std::size_t max_fen_size = 128;
+
+    // Writes the FEN into a buffer of at least max_fen_size characters without allocating,
+    // returns one past the last character written, there's no null terminator
+    char *write_fen(char *out, const bool dfrc = false) const noexcept;
+
+    // Returns false and leaves packed as it was if there are more than 32 pieces,
+    // counters past the PackedPosition limits are capped
+    [[nodiscard]] bool pack(PackedPosition &packed) const noexcept;
+
+    // Returns false and leaves the position as it was if the bytes don't make a legal position
+    [[nodiscard]] bool unpack(const PackedPosition &packed) noexcept;
+
     [[nodiscard]] bool is_legal(const Move &m) const noexcept;
 
     [[nodiscard]] bool is_terminal() const noexcept {
-        return legal_moves().empty() || is_draw();
+        return !has_legal_move() || threefold() || fiftymoves();
     }
 
     [[nodiscard]] bool is_checkmate() const noexcept {
-        return legal_moves().empty() && in_check();
+        return in_check() && !has_legal_move();
     }
 
     [[nodiscard]] bool is_stalemate() const noexcept {
-        return legal_moves().empty() && !in_check();
+        return !in_check() && !has_legal_move();
     }
 
     [[nodiscard]] bool is_draw() const noexcept {
         return (threefold() || fiftymoves()) && !is_checkmate();
     }
 
+    // Stops at the first legal move found rather than generating them all
+    [[nodiscard]] bool has_legal_move() const noexcept;
+
+    // Everything is_terminal(), is_checkmate(), is_stalemate() and is_draw() would say, with one legal move search
+    // Checkmate takes priority over the fifty move rule, insufficient material is reported last
+    [[nodiscard]] Status status() const noexcept;
+
+    // Neither side can checkmate: bare kings, a single minor piece, or only bishops all on the same colour
+    [[nodiscard]] bool insufficient_material() const noexcept;
+
     [[nodiscard]] bool threefold() const noexcept {
         if (halfmove_clock_ < 8) {
             return false;
         }
 
+        // Nothing before the last capture, pawn move or null move can repeat, and it takes 4 plies to get back
+        const auto end = std::min(history_.size(), halfmoves());
         int repeats = 0;
-        for (std::size_t i = 2; i <= history_.size() && i <= halfmoves(); i += 2) {
+        for (std::size_t i = 4; i <= end; i += 2) {
             if (history_[history_.size() - i].hash == hash_) {
                 repeats++;
                 if (repeats >= 2) {
@@ -104,6 +235,11 @@ class Position {
         return false;
     }
 
+    // Whether the side to move can reach an earlier position with one reversible move, a repetition one move early
+    // ply is the distance from the search root, cycles that reach back past the root only count if that
+    // earlier position had already been repeated
+    [[nodiscard]] bool has_game_cycle(const int ply) const noexcept;
+
     [[nodiscard]] constexpr bool fiftymoves() const noexcept {
         return halfmove_clock_ >= 100;
     }
@@ -124,14 +260,49 @@ class Position {
 
     [[nodiscard]] Bitboard squares_attacked(const Side s) const noexcept;
 
-    [[nodiscard]] Bitboard checkers() const noexcept;
+    [[nodiscard]] Bitboard checkers() const noexcept {
+        return state().checkers;
+    }
 
     [[nodiscard]] Bitboard attackers(const Square sq, const Side s) const noexcept;
 
     [[nodiscard]] bool in_check() const noexcept {
-        return square_attacked(king_position(turn()), !turn());
+        return !state().checkers.empty();
+    }
+
+    // StateInfo for the side to move, calculated on first use and kept until the position changes
+    // Filling the cache writes to the position, so a const Position still can't be shared between threads
+    [[nodiscard]] const StateInfo &state() const noexcept {
+        if (!state_valid_) {
+            state_ = known_checkers_valid_ ? calculate_state(turn(), known_checkers_) : calculate_state(turn());
+            state_valid_ = true;
+        }
+        return state_;
+    }
+
+    // StateInfo for either side, always calculated from scratch
+    [[nodiscard]] StateInfo calculate_state(const Side s) const noexcept;
+
+    // CheckInfo for the side to move, calculated on first use like state()
+    [[nodiscard]] const CheckInfo &check_info() const noexcept {
+        if (!check_info_valid_) {
+            check_info_ = calculate_check_info();
+            check_info_valid_ = true;
+        }
+        return check_info_;
     }
 
+    // Whether the move checks the enemy king, directly, by discovery, through promotion, en passant or the castling rook
+    // Once check_info() has been calculated, makemove() reuses it to find the new position's checkers
+    [[nodiscard]] bool gives_check(const Move &move) const noexcept;
+
+    // Static exchange evaluation, the material the side to move expects to win from the exchange the move starts
+    // on its destination square, counted with piece_values
+    [[nodiscard]] int see(const Move &move) const noexcept;
+
+    // Whether see() is at least the threshold, often decided without playing out the whole exchange
+    [[nodiscard]] bool see_ge(const Move &move, const int threshold = 0) const noexcept;
+
     [[nodiscard]] Bitboard king_allowed() const noexcept;
 
     [[nodiscard]] Bitboard king_allowed(const Side s) const noexcept;
@@ -144,6 +315,8 @@ class Position {
 
     [[nodiscard]] std::vector<Move> check_evasions() const noexcept;
 
+    void check_evasions(MoveList &moves) const noexcept;
+
     [[nodiscard]] std::vector<Move> legal_moves() const noexcept;
 
     [[nodiscard]] std::vector<Move> legal_captures() const noexcept;
@@ -156,6 +329,12 @@ class Position {
 
     void legal_noncaptures(std::vector<Move> &moves) const noexcept;
 
+    void legal_moves(MoveList &moves) const noexcept;
+
+    void legal_captures(MoveList &moves) const noexcept;
+
+    void legal_noncaptures(MoveList &moves) const noexcept;
+
     [[nodiscard]] constexpr Bitboard passed_pawns() const noexcept {
         return passed_pawns(turn());
     }
@@ -184,48 +363,34 @@ class Position {
 
     [[nodiscard]] std::size_t count_moves() const noexcept;
 
+    // Legal move counts without generating the moves, en passant only counts for the side to move
+    [[nodiscard]] std::size_t count_moves(const Side s) const noexcept;
+
+    [[nodiscard]] std::size_t count_moves(const Side s, const Piece p) const noexcept;
+
     [[nodiscard]] std::uint64_t perft(const int depth) noexcept;
 
     [[nodiscard]] constexpr bool can_castle(const Side s, const MoveType mt) const noexcept {
-        if (s == Side::White) {
-            if (mt == MoveType::ksc) {
-                return castling_[0];
-            } else {
-                return castling_[1];
-            }
-        } else {
-            if (mt == MoveType::ksc) {
-                return castling_[2];
-            } else {
-                return castling_[3];
-            }
-        }
-        return true;
+        return castling_ & castling_bit(s, mt);
     }
 
     [[nodiscard]] std::uint64_t predict_hash(const Move &move) const noexcept;
 
-    [[nodiscard]] Move parse_move(const std::string &str) const {
-        const auto moves = legal_moves();
-        const auto wksc = str == "e1g1" && piece_on(squares::E1) == Piece::King && turn() == Side::White;
-        const auto wqsc = str == "e1c1" && piece_on(squares::E1) == Piece::King && turn() == Side::White;
-        const auto bksc = str == "e8g8" && piece_on(squares::E8) == Piece::King && turn() == Side::Black;
-        const auto bqsc = str == "e8c8" && piece_on(squares::E8) == Piece::King && turn() == Side::Black;
-        const auto ksc = wksc | bksc;
-        const auto qsc = wqsc | bqsc;
-        for (const auto &move : moves) {
-            if ((ksc && move.type() == MoveType::ksc) || (qsc && move.type() == MoveType::qsc) ||
-                static_cast<std::string>(move) == str) {
-                return move;
-            }
+    // Throws std::invalid_argument if the move isn't legal
+    [[nodiscard]] Move parse_move(const std::string_view str) const {
+        const auto move = try_parse_move(str);
+        if (!move) {
+            throw std::invalid_argument("Illegal move string");
         }
-
-        throw std::invalid_argument("Illegal move string");
+        return move;
     }
 
+    // Returns the null move if the string isn't a legal move, accepts both standard and Chess960 castling
+    [[nodiscard]] Move try_parse_move(const std::string_view str) const noexcept;
+
     void makemove(const Move &move) noexcept;
 
-    void makemove(const std::string &str) {
+    void makemove(const std::string_view str) {
         const auto move = parse_move(str);
         makemove(move);
     }
@@ -233,12 +398,14 @@ class Position {
     void undomove() noexcept;
 
     void makenull() noexcept {
+        invalidate_state();
+        reserve_history();
         history_.push_back(meh{
             hash(),
             {},
             ep_,
-            halfmoves(),
-            {},
+            castling_,
+            static_cast<std::uint16_t>(halfmoves()),
         });
 
 #ifndef NO_HASH
@@ -254,6 +421,7 @@ class Position {
     }
 
     void undonull() noexcept {
+        invalidate_state();
         hash_ = history_.back().hash;
         ep_ = history_.back().ep;
         halfmove_clock_ = history_.back().halfmove_clock;
@@ -292,18 +460,7 @@ class Position {
         }
 
         // Castling
-        if (can_castle(Side::White, MoveType::ksc)) {
-            hash ^= zobrist::castling_key(usKSC);
-        }
-        if (can_castle(Side::White, MoveType::qsc)) {
-            hash ^= zobrist::castling_key(usQSC);
-        }
-        if (can_castle(Side::Black, MoveType::ksc)) {
-            hash ^= zobrist::castling_key(themKSC);
-        }
-        if (can_castle(Side::Black, MoveType::qsc)) {
-            hash ^= zobrist::castling_key(themQSC);
-        }
+        hash ^= zobrist::castling_rights_key(castling_);
 
         // EP
         if (ep_ != squares::OffSq) {
@@ -313,17 +470,49 @@ class Position {
         return hash;
     }
 
+    [[nodiscard]] constexpr std::uint64_t calculate_pawn_hash() const noexcept {
+        std::uint64_t hash = 0;
+        for (const auto s : {Side::White, Side::Black}) {
+            for (const auto &sq : pieces(s, Piece::Pawn)) {
+                hash ^= zobrist::piece_key(Piece::Pawn, s, sq);
+            }
+        }
+        return hash;
+    }
+
+    // The count of each piece type is keyed as if it were a square, the king is left out as there's always one
+    [[nodiscard]] constexpr std::uint64_t calculate_material_hash() const noexcept {
+        std::uint64_t hash = 0;
+        for (const auto s : {Side::White, Side::Black}) {
+            for (const auto p : {Piece::Pawn, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen}) {
+                for (int i = 0; i < piece_count(s, p); ++i) {
+                    hash ^= zobrist::piece_key(p, s, Square{i});
+                }
+            }
+        }
+        return hash;
+    }
+
+    [[nodiscard]] constexpr int calculate_non_pawn_material(const Side s) const noexcept {
+        int total = 0;
+        for (const auto p : {Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen}) {
+            total += piece_count(s, p) * piece_values[p];
+        }
+        return total;
+    }
+
     [[nodiscard]] auto &history() const noexcept {
         return history_;
     }
 
     [[nodiscard]] constexpr Piece piece_on(const Square sq) const noexcept {
-        for (int i = 0; i < 6; ++i) {
-            if (pieces_[i] & Bitboard{sq}) {
-                return Piece(i);
-            }
-        }
-        return Piece::None;
+        return static_cast<Piece>(mailbox_[static_cast<int>(sq)]);
+    }
+
+    // The square has to be occupied
+    [[nodiscard]] constexpr Side owner_on(const Square sq) const noexcept {
+        assert(piece_on(sq) != Piece::None);
+        return colours_[Side::Black] & Bitboard{sq} ? Side::Black : Side::White;
     }
 
     [[nodiscard]] constexpr Square ep() const noexcept {
@@ -343,12 +532,15 @@ class Position {
         fullmove_clock_ = 0;
         ep_ = squares::OffSq;
         hash_ = 0x0;
-        castling_[0] = false;
-        castling_[1] = false;
-        castling_[2] = false;
-        castling_[3] = false;
+        pawn_hash_ = 0x0;
+        material_hash_ = 0x0;
+        non_pawn_material_ = {};
+        castling_ = 0;
+        castling_mask_ = make_castling_mask();
         to_move_ = Side::White;
         history_.clear();
+        mailbox_.fill(Piece::None);
+        invalidate_state();
     }
 
     [[nodiscard]] bool valid() const noexcept;
@@ -370,49 +562,200 @@ class Position {
     }
 
     [[nodiscard]] auto move_string(const Move &move, const bool dfrc = false) const noexcept -> std::string {
-        if (dfrc) {
-            return static_cast<std::string>(move);
-        } else if (move.type() == MoveType::ksc) {
-            if (turn() == Side::White) {
-                return "e1g1";
-            } else {
-                return "e8g8";
-            }
-        } else if (move.type() == MoveType::qsc) {
-            if (turn() == Side::White) {
-                return "e1c1";
-            } else {
-                return "e8c8";
-            }
-        } else {
-            return static_cast<std::string>(move);
+        char buffer[5];
+        return std::string(buffer, write_uci(buffer, move, dfrc));
+    }
+
+    // Writes move_string() into a buffer of at least 5 characters, returns one past the last character written
+    char *write_uci(char *out, const Move &move, const bool dfrc = false) const noexcept;
+
+    // Longest SAN write_san() can produce, like "Qa1xb2#" or "exd8=Q+"
+    static constexpr std::size_t max_san_size = 7;
+
+    // One SAN move, null terminated
+    using SanString = std::array<char, max_san_size + 1>;
+
+    // Writes the move in SAN into a buffer of at least max_san_size characters, returns one past the last character
+    // written, there's no null terminator
+    char *write_san(char *out, const Move &move) const noexcept;
+
+    // SAN of every move in the list at once, the list has to be all the legal moves in the position
+    // out needs room for moves.size() strings
+    void write_san(const MoveList &moves, SanString *out) const noexcept;
+
+    [[nodiscard]] std::string san_string(const Move &move) const {
+        char buffer[max_san_size];
+        return std::string(buffer, write_san(buffer, move));
+    }
+
+    // Returns the null move if the string isn't a legal move in SAN
+    // Castling is O-O or O-O-O, check and annotation suffixes like + # ! ? are ignored, as is a missing capture mark
+    [[nodiscard]] Move try_parse_san(const std::string_view str) const noexcept;
+
+    // Throws std::invalid_argument if the move isn't legal
+    [[nodiscard]] Move parse_san(const std::string_view str) const {
+        const auto move = try_parse_san(str);
+        if (!move) {
+            throw std::invalid_argument("Illegal SAN move string");
         }
+        return move;
     }
 
    private:
+    [[nodiscard]] static constexpr std::array<std::uint8_t, 64> make_empty_mailbox() noexcept {
+        std::array<std::uint8_t, 64> mailbox = {};
+        mailbox.fill(Piece::None);
+        return mailbox;
+    }
+
+    [[nodiscard]] static constexpr std::array<std::uint8_t, 64> make_castling_mask() noexcept {
+        std::array<std::uint8_t, 64> mask = {};
+        mask.fill(0xF);
+        return mask;
+    }
+
+    template <Side Us, typename T>
+    void generate_captures(T &moves) const noexcept;
+
+    template <Side Us, typename T>
+    void generate_noncaptures(T &moves) const noexcept;
+
+    template <Side Us>
+    void makemove(const Move &move) noexcept;
+
+    template <Side Us>
+    void undomove() noexcept;
+
+    // Pawn and material key changes for a move by Us, XOR so the same call undoes them
+    // Must be called with the board as it was before the move
+    template <Side Us>
+    void update_keys(const Move &move) noexcept;
+
+    template <Side S>
+    [[nodiscard]] Bitboard squares_attacked() const noexcept;
+
+    template <Side S>
+    [[nodiscard]] Bitboard king_allowed() const noexcept;
+
+    template <Side S>
+    [[nodiscard]] StateInfo calculate_state(const Bitboard checkers) const noexcept;
+
+    [[nodiscard]] StateInfo calculate_state(const Side s, const Bitboard checkers) const noexcept;
+
+    [[nodiscard]] CheckInfo calculate_check_info() const noexcept;
+
+    // Whether side s attacks sq on bitboards that aren't in a position yet, for try_set_fen() and unpack()
+    [[nodiscard]] static bool attacked_by(const Bitboard *colour_bb,
+                                          const Bitboard *piece_bb,
+                                          const Square sq,
+                                          const Side s) noexcept;
+
+    // The enemy pieces giving check once the move is made
+    [[nodiscard]] Bitboard checkers_after(const Move &move) const noexcept;
+
+    constexpr void invalidate_state() noexcept {
+        state_valid_ = false;
+        check_info_valid_ = false;
+        known_checkers_valid_ = false;
+    }
+
+    template <Side Us>
+    [[nodiscard]] bool is_legal(const Move &m) const noexcept;
+
+    [[nodiscard]] bool respects_check_and_pins(const Square from, const Square to) const noexcept;
+
+    [[nodiscard]] Move candidate_move(const Square from, const Square to, const Piece promo) const noexcept;
+
     void set(const Square sq, const Side s, const Piece p) noexcept {
         colours_[s] |= sq;
         pieces_[p] |= sq;
+        set_mailbox(sq, p);
+        invalidate_state();
+    }
+
+    constexpr void set_mailbox(const Square sq, const Piece p) noexcept {
+        mailbox_[static_cast<int>(sq)] = p;
+    }
+
+    // Bit for each castling right: white ksc, white qsc, black ksc, black qsc
+    [[nodiscard]] static constexpr std::uint8_t castling_bit(const Side s, const MoveType mt) noexcept {
+        return 1 << (2 * s + (mt == MoveType::ksc ? 0 : 1));
+    }
+
+    // Copies everything but the undo history, which is left empty with room for one record, for scratch positions
+    // that only make and unmake a move on top
+    void assign_without_history(const Position &other) noexcept;
+
+    // Hashes and non-pawn material worked out from scratch, for set_fen() and unpack()
+    void set_keys() noexcept;
+
+    // Castling rights that survive a piece leaving or landing on each square, built by set_fen()
+    void set_castling_mask() noexcept;
+
+    // The undo history is only reserved once a move is made, so positions that are set up and never played on don't
+    // allocate
+    void reserve_history() {
+        if (history_.size() == history_.capacity() && history_.capacity() < LIBCHESS_MAX_PLY) {
+            history_.reserve(LIBCHESS_MAX_PLY);
+        }
     }
 
+    // Undo record, packed so a makemove/undomove pair only touches a quarter of a cache line
     struct meh {
         std::uint64_t hash = 0;
         Move move;
         Square ep;
-        std::size_t halfmove_clock = 0;
-        bool castling[4] = {};
+        std::uint8_t castling = 0;
+        std::uint16_t halfmove_clock = 0;
+    };
+    static_assert(sizeof(meh) == 16);
+
+    // Undo records that keep their capacity when copied, so a copy of a position that has been played on, like a
+    // perft worker's, doesn't reallocate on its first move
+    class History : public std::vector<meh> {
+       public:
+        History() = default;
+        History(History &&) noexcept = default;
+        History &operator=(History &&) noexcept = default;
+        ~History() = default;
+
+        History(const History &other) : std::vector<meh>() {
+            reserve(other.capacity());
+            assign(other.begin(), other.end());
+        }
+
+        History &operator=(const History &other) {
+            if (this != &other) {
+                reserve(other.capacity());
+                assign(other.begin(), other.end());
+            }
+            return *this;
+        }
     };
 
     Bitboard colours_[2] = {};
     Bitboard pieces_[6] = {};
+    // Piece on each square kept alongside the bitboards, one byte per square
+    std::array<std::uint8_t, 64> mailbox_ = make_empty_mailbox();
     std::size_t halfmove_clock_ = 0;
     std::size_t fullmove_clock_ = 0;
     Square ep_ = squares::OffSq;
     std::uint64_t hash_ = 0;
-    bool castling_[4] = {};
+    std::uint64_t pawn_hash_ = 0;
+    std::uint64_t material_hash_ = 0;
+    std::array<int, 2> non_pawn_material_ = {};
+    std::uint8_t castling_ = 0;
+    std::array<std::uint8_t, 64> castling_mask_ = make_castling_mask();
     std::array<Square, 4> castle_rooks_from_ = {{squares::H1, squares::A1, squares::H8, squares::A8}};
     Side to_move_ = Side::White;
-    std::vector<meh> history_;
+    History history_;
+    mutable StateInfo state_;
+    mutable bool state_valid_ = false;
+    mutable CheckInfo check_info_;
+    mutable bool check_info_valid_ = false;
+    // Checkers worked out by makemove(), saves calculating them again in state()
+    Bitboard known_checkers_;
+    bool known_checkers_valid_ = false;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Position &pos) noexcept {
@@ -126,6 +126,10 @@ constexpr auto A2 = Square(8);
 constexpr auto B2 = Square(9);
 constexpr auto C2 = Square(10);
 constexpr auto D2 = Square(11);
+constexpr auto E2 = Square(12);
+constexpr auto F2 = Square(13);
+constexpr auto G2 = Square(14);
+constexpr auto H2 = Square(15);
 
 constexpr auto A3 = Square(16);
 constexpr auto B3 = Square(17);
@@ -137,7 +141,13 @@ constexpr auto G3 = Square(22);
 constexpr auto H3 = Square(23);
 
 constexpr auto A4 = Square(24);
+constexpr auto B4 = Square(25);
+constexpr auto C4 = Square(26);
 constexpr auto D4 = Square(27);
+constexpr auto E4 = Square(28);
+constexpr auto F4 = Square(29);
+constexpr auto G4 = Square(30);
+constexpr auto H4 = Square(31);
 
 constexpr auto A5 = Square(32);
 constexpr auto B5 = Square(33);
@@ -146,14 +156,25 @@ constexpr auto D5 = Square(35);
 constexpr auto E5 = Square(36);
 constexpr auto F5 = Square(37);
 constexpr auto G5 = Square(38);
+constexpr auto H5 = Square(39);
 
 constexpr auto A6 = Square(40);
+constexpr auto B6 = Square(41);
+constexpr auto C6 = Square(42);
+constexpr auto D6 = Square(43);
+constexpr auto E6 = Square(44);
+constexpr auto F6 = Square(45);
+constexpr auto G6 = Square(46);
 constexpr auto H6 = Square(47);
 
 constexpr auto A7 = Square(48);
 constexpr auto B7 = Square(49);
+constexpr auto C7 = Square(50);
+constexpr auto D7 = Square(51);
+constexpr auto E7 = Square(52);
 constexpr auto F7 = Square(53);
 constexpr auto G7 = Square(54);
+constexpr auto H7 = Square(55);
 
 constexpr auto A8 = Square(56);
 constexpr auto B8 = Square(57);
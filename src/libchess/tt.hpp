@@ -0,0 +1,117 @@
+#ifndef LIBCHESS_TT_HPP
+#define LIBCHESS_TT_HPP
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace libchess {
+
+// Hash table shared between threads without locks
+// Each entry is two words, the data and the hash XOR the data, written and read separately with relaxed atomics
+// A torn entry from two threads writing at once no longer matches its hash and reads as a miss
+// Entries are grouped into cache line sized buckets, a new entry replaces the same hash or else the shallowest entry
+class TT {
+   public:
+    // 56 bits of data per entry, the top byte holds the depth
+    static constexpr std::uint64_t max_data = (1ULL << 56) - 1;
+
+    [[nodiscard]] explicit TT(const std::size_t mb = 1) {
+        resize(mb);
+    }
+
+    TT(const TT &) = delete;
+
+    TT &operator=(const TT &) = delete;
+
+    ~TT();
+
+    // Reallocates and clears the table, not safe while other threads are using it
+    void resize(std::size_t mb);
+
+    // Not safe while other threads are using the table
+    void clear() noexcept;
+
+    [[nodiscard]] bool probe(const std::uint64_t hash, std::uint64_t &data, int &depth) const noexcept {
+        for (auto &entry : bucket(hash).entries) {
+            const auto word = load(entry.data);
+            if ((load(entry.key) ^ word) == hash && (word || hash)) {
+                data = word & max_data;
+                depth = static_cast<int>(word >> 56);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(const std::uint64_t hash, const std::uint64_t data, const int depth) noexcept {
+        assert(data <= max_data);
+        assert(0 <= depth && depth <= 255);
+
+        auto &b = bucket(hash);
+        auto *replace = &b.entries[0];
+        for (auto &entry : b.entries) {
+            const auto word = load(entry.data);
+            const auto key = load(entry.key);
+
+            // Same position or an empty slot
+            if ((key ^ word) == hash || (key == 0 && word == 0)) {
+                replace = &entry;
+                break;
+            }
+
+            if ((word >> 56) < (load(replace->data) >> 56)) {
+                replace = &entry;
+            }
+        }
+
+        const auto word = (static_cast<std::uint64_t>(depth) << 56) | data;
+        std::atomic_ref<std::uint64_t>{replace->key}.store(hash ^ word, std::memory_order_relaxed);
+        std::atomic_ref<std::uint64_t>{replace->data}.store(word, std::memory_order_relaxed);
+    }
+
+    void prefetch(const std::uint64_t hash) const noexcept {
+        __builtin_prefetch(&bucket(hash));
+    }
+
+    // Permille of entries in use, sampled from the first buckets
+    [[nodiscard]] int hashfull() const noexcept;
+
+    // Number of entries
+    [[nodiscard]] std::size_t size() const noexcept {
+        return num_buckets_ * bucket_size;
+    }
+
+   private:
+    static constexpr std::size_t bucket_size = 4;
+
+    struct Entry {
+        std::uint64_t key;
+        std::uint64_t data;
+    };
+
+    struct alignas(64) Bucket {
+        std::array<Entry, bucket_size> entries;
+    };
+
+    static_assert(sizeof(Bucket) == 64);
+
+    [[nodiscard]] static std::uint64_t load(std::uint64_t &word) noexcept {
+        return std::atomic_ref<std::uint64_t>{word}.load(std::memory_order_relaxed);
+    }
+
+    // The number of buckets is a power of two so the low bits of the hash pick one
+    [[nodiscard]] Bucket &bucket(const std::uint64_t hash) const noexcept {
+        return buckets_[hash & (num_buckets_ - 1)];
+    }
+
+    Bucket *buckets_ = nullptr;
+    std::size_t num_buckets_ = 0;
+    std::size_t allocated_ = 0;
+};
+
+}  // namespace libchess
+
+#endif
@@ -3,8 +3,25 @@
 namespace libchess {
 
 void Position::makemove(const Move &move) noexcept {
-    const auto us = turn();
-    const auto them = !turn();
+    // If the check info is around the new checkers come almost for free, otherwise leave them to state()
+    const auto predicted = check_info_valid_;
+    const auto checkers = predicted ? checkers_after(move) : Bitboard{};
+
+    invalidate_state();
+    if (turn() == Side::White) {
+        makemove<Side::White>(move);
+    } else {
+        makemove<Side::Black>(move);
+    }
+
+    known_checkers_ = checkers;
+    known_checkers_valid_ = predicted;
+}
+
+template <Side Us>
+void Position::makemove(const Move &move) noexcept {
+    assert(turn() == Us);
+    constexpr auto them = !Us;
     const auto to = move.to();
     const auto from = move.from();
     const auto piece = move.piece();
@@ -22,8 +39,13 @@ void Position::makemove(const Move &move) noexcept {
     assert(promo != Piece::King);
     assert(piece_on(move.from()) == piece);
 
+    // Pawn and material keys
+    update_keys<Us>(move);
+    non_pawn_material_[them] -= captured == Piece::Pawn ? 0 : piece_values[captured];
+    non_pawn_material_[Us] += piece_values[promo];
+
     // Fullmoves
-    fullmove_clock_ += us == Side::Black;
+    fullmove_clock_ += Us == Side::Black;
 
 #ifndef NO_HASH
     hash_ ^= zobrist::turn_key();
@@ -40,25 +62,28 @@ void Position::makemove(const Move &move) noexcept {
 
     switch (type) {
         case MoveType::Normal:
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
             pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(move.to());
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, move.to());
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, move.to());
 #endif
             assert(captured == Piece::None);
             assert(promo == Piece::None);
 
+            set_mailbox(from, Piece::None);
+            set_mailbox(to, piece);
+
             if (piece == Piece::Pawn) {
                 halfmove_clock_ = 0;
             }
             break;
         case MoveType::Capture:
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
             pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(move.to());
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, move.to());
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, move.to());
 #endif
             assert(captured != Piece::None);
             assert(promo == Piece::None);
@@ -72,201 +97,231 @@ void Position::makemove(const Move &move) noexcept {
             // Remove the captured piece
             pieces_[captured] ^= move.to();
             colours_[them] ^= move.to();
+
+            set_mailbox(from, Piece::None);
+            set_mailbox(to, piece);
             break;
         case MoveType::Double:
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
             pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(move.to());
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, move.to());
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, move.to());
 #endif
             assert(piece == Piece::Pawn);
             assert(captured == Piece::None);
             assert(promo == Piece::None);
             assert(to.file() == from.file());
-            assert((us == Side::White && move.to().rank() == 3) || (us == Side::Black && move.to().rank() == 4));
-            assert((us == Side::White && move.from().rank() == 1) || (us == Side::Black && move.from().rank() == 6));
+            assert((Us == Side::White && move.to().rank() == 3) || (Us == Side::Black && move.to().rank() == 4));
+            assert((Us == Side::White && move.from().rank() == 1) || (Us == Side::Black && move.from().rank() == 6));
+
+            set_mailbox(from, Piece::None);
+            set_mailbox(to, piece);
 
             halfmove_clock_ = 0;
-            ep_ = us == Side::White ? to.south() : to.north();
+            if constexpr (Us == Side::White) {
+                ep_ = to.south();
+            } else {
+                ep_ = to.north();
+            }
 
 #ifndef NO_HASH
             hash_ ^= zobrist::ep_key(ep_);
 #endif
             break;
         case MoveType::enpassant:
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
             pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(move.to());
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, move.to());
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, move.to());
 #endif
             assert(piece == Piece::Pawn);
             assert(captured == Piece::Pawn);
             assert(promo == Piece::None);
             assert(to.file() == ep_old.file());
-            assert((us == Side::White && move.to().rank() == 5) || (us == Side::Black && move.to().rank() == 2));
-            assert((us == Side::White && move.from().rank() == 4) || (us == Side::Black && move.from().rank() == 3));
+            assert((Us == Side::White && move.to().rank() == 5) || (Us == Side::Black && move.to().rank() == 2));
+            assert((Us == Side::White && move.from().rank() == 4) || (Us == Side::Black && move.from().rank() == 3));
             assert(to.file() - from.file() == 1 || from.file() - to.file() == 1);
 
             halfmove_clock_ = 0;
 
             // Remove the captured pawn
-            if (turn() == Side::White) {
+            if constexpr (Us == Side::White) {
                 pieces_[Piece::Pawn] ^= move.to().south();
                 colours_[Side::Black] ^= move.to().south();
+                set_mailbox(move.to().south(), Piece::None);
 #ifndef NO_HASH
                 hash_ ^= zobrist::piece_key(Piece::Pawn, them, move.to().south());
 #endif
             } else {
                 pieces_[Piece::Pawn] ^= move.to().north();
                 colours_[Side::White] ^= move.to().north();
+                set_mailbox(move.to().north(), Piece::None);
 #ifndef NO_HASH
                 hash_ ^= zobrist::piece_key(Piece::Pawn, them, move.to().north());
 #endif
             }
+
+            set_mailbox(from, Piece::None);
+            set_mailbox(to, piece);
             break;
         case MoveType::ksc:
             assert(piece_on(move.from()) == Piece::King);
             assert(piece_on(move.to()) == Piece::Rook);
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[us * 2]);
-            pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[us * 2]);
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[Us * 2]);
+            pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[Us * 2]);
 
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, castle_king_to[us * 2]);
-            hash_ ^= zobrist::piece_key(Piece::Rook, us, castle_rooks_from_[us * 2]);
-            hash_ ^= zobrist::piece_key(Piece::Rook, us, ksc_rook_to[us]);
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, castle_king_to[Us * 2]);
+            hash_ ^= zobrist::piece_key(Piece::Rook, Us, castle_rooks_from_[Us * 2]);
+            hash_ ^= zobrist::piece_key(Piece::Rook, Us, ksc_rook_to[Us]);
 #endif
 
             // Remove the rook
-            colours_[us] ^= castle_rooks_from_[us * 2];
-            pieces_[Piece::Rook] ^= castle_rooks_from_[us * 2];
+            colours_[Us] ^= castle_rooks_from_[Us * 2];
+            pieces_[Piece::Rook] ^= castle_rooks_from_[Us * 2];
             // Add the rook
-            colours_[us] ^= ksc_rook_to[us];
-            pieces_[Piece::Rook] ^= ksc_rook_to[us];
+            colours_[Us] ^= ksc_rook_to[Us];
+            pieces_[Piece::Rook] ^= ksc_rook_to[Us];
+
+            // The king and rook squares can overlap in Chess960, so clear both before placing either
+            set_mailbox(from, Piece::None);
+            set_mailbox(castle_rooks_from_[Us * 2], Piece::None);
+            set_mailbox(ksc_rook_to[Us], Piece::Rook);
+            set_mailbox(castle_king_to[Us * 2], Piece::King);
 
             assert(piece == Piece::King);
             assert(captured == Piece::None);
             assert(promo == Piece::None);
-            assert(can_castle(us, MoveType::ksc));
-            assert(move.to() == castle_rooks_from_[us * 2]);
+            assert(can_castle(Us, MoveType::ksc));
+            assert(move.to() == castle_rooks_from_[Us * 2]);
 
             // No overlap between any pieces and the path of the king, exclude the castling rook
-            assert(!(occupied() & squares_between(from, castle_king_to[us * 2]) & ~Bitboard(ksc_rook_to[us])));
+            assert(!(occupied() & squares_between(from, castle_king_to[Us * 2]) & ~Bitboard(ksc_rook_to[Us])));
             // No overlap between any pieces and the path of the rook, exclude the castled king
             assert(
-                !(occupied() & squares_between(castle_rooks_from_[us * 2], ksc_rook_to[us]) & ~occupancy(Piece::King)));
+                !(occupied() & squares_between(castle_rooks_from_[Us * 2], ksc_rook_to[Us]) & ~occupancy(Piece::King)));
 
             // Check if rook is at destination
-            assert(piece_on(ksc_rook_to[us]) == Piece::Rook);
+            assert(piece_on(ksc_rook_to[Us]) == Piece::Rook);
             // Check that king is on its destination square
-            assert(piece_on(castle_king_to[us * 2]) == Piece::King);
+            assert(piece_on(castle_king_to[Us * 2]) == Piece::King);
 
             // Start square of king is either empty, its own, or the rook's target square
-            assert(piece_on(from) == Piece::None || from == ksc_rook_to[us] || from == castle_king_to[us * 2]);
+            assert(piece_on(from) == Piece::None || from == ksc_rook_to[Us] || from == castle_king_to[Us * 2]);
             // Start square of rook is either empty, its own, or the king's target square
-            assert(piece_on(castle_rooks_from_[us * 2]) == Piece::None ||
-                   castle_rooks_from_[us * 2] == ksc_rook_to[us] ||
-                   castle_rooks_from_[us * 2] == castle_king_to[us * 2]);
+            assert(piece_on(castle_rooks_from_[Us * 2]) == Piece::None ||
+                   castle_rooks_from_[Us * 2] == ksc_rook_to[Us] ||
+                   castle_rooks_from_[Us * 2] == castle_king_to[Us * 2]);
 
             // Check if all squares touched by king are not attacked
             assert(!(squares_attacked(them) &
-                     (squares_between(from, castle_king_to[us * 2]) | from | pieces(us, Piece::King))));
+                     (squares_between(from, castle_king_to[Us * 2]) | from | pieces(Us, Piece::King))));
 
             break;
         case MoveType::qsc:
             assert(piece_on(move.from()) == Piece::King);
             assert(piece_on(move.to()) == Piece::Rook);
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[us * 2 + 1]);
-            pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[us * 2 + 1]);
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[Us * 2 + 1]);
+            pieces_[piece] ^= Bitboard(move.from()) ^ Bitboard(castle_king_to[Us * 2 + 1]);
 
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, castle_king_to[us * 2 + 1]);
-            hash_ ^= zobrist::piece_key(Piece::Rook, us, castle_rooks_from_[us * 2 + 1]);
-            hash_ ^= zobrist::piece_key(Piece::Rook, us, qsc_rook_to[us]);
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, castle_king_to[Us * 2 + 1]);
+            hash_ ^= zobrist::piece_key(Piece::Rook, Us, castle_rooks_from_[Us * 2 + 1]);
+            hash_ ^= zobrist::piece_key(Piece::Rook, Us, qsc_rook_to[Us]);
 #endif
 
             // Remove the rook
-            colours_[us] ^= castle_rooks_from_[us * 2 + 1];
-            pieces_[Piece::Rook] ^= castle_rooks_from_[us * 2 + 1];
+            colours_[Us] ^= castle_rooks_from_[Us * 2 + 1];
+            pieces_[Piece::Rook] ^= castle_rooks_from_[Us * 2 + 1];
             // Add the rook
-            colours_[us] ^= qsc_rook_to[us];
-            pieces_[Piece::Rook] ^= qsc_rook_to[us];
+            colours_[Us] ^= qsc_rook_to[Us];
+            pieces_[Piece::Rook] ^= qsc_rook_to[Us];
+
+            // The king and rook squares can overlap in Chess960, so clear both before placing either
+            set_mailbox(from, Piece::None);
+            set_mailbox(castle_rooks_from_[Us * 2 + 1], Piece::None);
+            set_mailbox(qsc_rook_to[Us], Piece::Rook);
+            set_mailbox(castle_king_to[Us * 2 + 1], Piece::King);
             assert(piece == Piece::King);
             assert(captured == Piece::None);
             assert(promo == Piece::None);
-            assert(can_castle(us, MoveType::qsc));
-            assert(move.to() == castle_rooks_from_[us * 2 + 1]);
+            assert(can_castle(Us, MoveType::qsc));
+            assert(move.to() == castle_rooks_from_[Us * 2 + 1]);
             // No overlap between any pieces and the path of the king, exclude the castling rook
-            assert(!(occupied() & squares_between(from, castle_king_to[us * 2 + 1]) & ~Bitboard(qsc_rook_to[us])));
+            assert(!(occupied() & squares_between(from, castle_king_to[Us * 2 + 1]) & ~Bitboard(qsc_rook_to[Us])));
             // No overlap between any pieces and the path of the rook, exclude the castled king
-            assert(!(occupied() & squares_between(castle_rooks_from_[us * 2 + 1], qsc_rook_to[us]) &
+            assert(!(occupied() & squares_between(castle_rooks_from_[Us * 2 + 1], qsc_rook_to[Us]) &
                      ~occupancy(Piece::King)));
 
             // Check if rook is at destination
-            assert(piece_on(qsc_rook_to[us]) == Piece::Rook);
+            assert(piece_on(qsc_rook_to[Us]) == Piece::Rook);
             // Check that king is on its destination square
-            assert(piece_on(castle_king_to[us * 2 + 1]) == Piece::King);
-            assert(castle_king_to[us * 2 + 1] == pieces(us, Piece::King).hsb());
+            assert(piece_on(castle_king_to[Us * 2 + 1]) == Piece::King);
+            assert(castle_king_to[Us * 2 + 1] == pieces(Us, Piece::King).hsb());
 
             // Start square of rook is either empty, its own, or the king's target square
-            assert(piece_on(castle_rooks_from_[us * 2 + 1]) == Piece::None ||
-                   castle_rooks_from_[us * 2 + 1] == qsc_rook_to[us] ||
-                   castle_rooks_from_[us * 2 + 1] == castle_king_to[us * 2 + 1]);
+            assert(piece_on(castle_rooks_from_[Us * 2 + 1]) == Piece::None ||
+                   castle_rooks_from_[Us * 2 + 1] == qsc_rook_to[Us] ||
+                   castle_rooks_from_[Us * 2 + 1] == castle_king_to[Us * 2 + 1]);
             // Start square of king is either empty, its own, or the rook's target square
-            assert(piece_on(from) == Piece::None || from == qsc_rook_to[us] || from == castle_king_to[us * 2 + 1]);
+            assert(piece_on(from) == Piece::None || from == qsc_rook_to[Us] || from == castle_king_to[Us * 2 + 1]);
 
             // Check if all squares touched by king are not attacked
             assert(!(squares_attacked(them) &
-                     (squares_between(from, castle_king_to[us * 2 + 1]) | from | pieces(us, Piece::King))));
+                     (squares_between(from, castle_king_to[Us * 2 + 1]) | from | pieces(Us, Piece::King))));
 
             break;
         case MoveType::promo:
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
             pieces_[Piece::Pawn] ^= Bitboard(move.from());
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, move.to());
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, move.to());
 #endif
             assert(piece == Piece::Pawn);
             assert(captured == Piece::None);
             assert(promo != Piece::None);
             assert(move.to().file() == move.from().file());
-            assert((us == Side::White && move.to().rank() == 7) || (us == Side::Black && move.to().rank() == 0));
-            assert((us == Side::White && move.from().rank() == 6) || (us == Side::Black && move.from().rank() == 1));
+            assert((Us == Side::White && move.to().rank() == 7) || (Us == Side::Black && move.to().rank() == 0));
+            assert((Us == Side::White && move.from().rank() == 6) || (Us == Side::Black && move.from().rank() == 1));
 
             halfmove_clock_ = 0;
 
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(Piece::Pawn, us, move.to());
-            hash_ ^= zobrist::piece_key(promo, us, move.to());
+            hash_ ^= zobrist::piece_key(Piece::Pawn, Us, move.to());
+            hash_ ^= zobrist::piece_key(promo, Us, move.to());
 #endif
 
             // Replace pawn with piece
             pieces_[promo] ^= move.to();
+
+            set_mailbox(from, Piece::None);
+            set_mailbox(to, promo);
             break;
         case MoveType::promo_capture:
-            colours_[us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
+            colours_[Us] ^= Bitboard(move.from()) ^ Bitboard(move.to());
             pieces_[Piece::Pawn] ^= Bitboard(move.from());
 #ifndef NO_HASH
-            hash_ ^= zobrist::piece_key(piece, us, move.from());
-            hash_ ^= zobrist::piece_key(piece, us, move.to());
+            hash_ ^= zobrist::piece_key(piece, Us, move.from());
+            hash_ ^= zobrist::piece_key(piece, Us, move.to());
 #endif
             assert(piece == Piece::Pawn);
             assert(captured != Piece::None);
             assert(promo != Piece::None);
             assert(move.to().file() != move.from().file());
-            assert((us == Side::White && move.to().rank() == 7) || (us == Side::Black && move.to().rank() == 0));
-            assert((us == Side::White && move.from().rank() == 6) || (us == Side::Black && move.from().rank() == 1));
+            assert((Us == Side::White && move.to().rank() == 7) || (Us == Side::Black && move.to().rank() == 0));
+            assert((Us == Side::White && move.from().rank() == 6) || (Us == Side::Black && move.from().rank() == 1));
 
             halfmove_clock_ = 0;
 
 #ifndef NO_HASH
             hash_ ^= zobrist::piece_key(captured, them, move.to());
-            hash_ ^= zobrist::piece_key(Piece::Pawn, us, move.to());
-            hash_ ^= zobrist::piece_key(promo, us, move.to());
+            hash_ ^= zobrist::piece_key(Piece::Pawn, Us, move.to());
+            hash_ ^= zobrist::piece_key(promo, Us, move.to());
 #endif
 
             // Replace pawn with piece
@@ -274,47 +329,23 @@ void Position::makemove(const Move &move) noexcept {
             // Remove the captured piece
             pieces_[captured] ^= move.to();
             colours_[them] ^= move.to();
+
+            set_mailbox(from, Piece::None);
+            set_mailbox(to, promo);
             break;
         default:
             abort();
     }
 
-#ifndef NO_HASH
-    const bool castling_old[] = {
-        castling_[0],
-        castling_[1],
-        castling_[2],
-        castling_[3],
-    };
-#endif
-
     // Add to history
-    history_.push_back(
-        meh{hash_old, move, ep_old, halfmove_clock_old, {castling_[0], castling_[1], castling_[2], castling_[3]}});
-
-    // Castling permissions
-    castling_[usKSC] &=
-        !((piece == Piece::King && us == Side::White) || from == castle_rooks_from_[0] || to == castle_rooks_from_[0]);
-    castling_[usQSC] &=
-        !((piece == Piece::King && us == Side::White) || from == castle_rooks_from_[1] || to == castle_rooks_from_[1]);
-    castling_[themKSC] &=
-        !((piece == Piece::King && us == Side::Black) || from == castle_rooks_from_[2] || to == castle_rooks_from_[2]);
-    castling_[themQSC] &=
-        !((piece == Piece::King && us == Side::Black) || from == castle_rooks_from_[3] || to == castle_rooks_from_[3]);
+    reserve_history();
+    history_.push_back(meh{hash_old, move, ep_old, castling_, static_cast<std::uint16_t>(halfmove_clock_old)});
 
+    // Castling permissions -- lost when the king or rook moves, or the rook is captured
+    const auto castling_old = castling_;
+    castling_ &= castling_mask_[static_cast<int>(from)] & castling_mask_[static_cast<int>(to)];
 #ifndef NO_HASH
-    if (castling_[usKSC] != castling_old[usKSC]) {
-        hash_ ^= zobrist::castling_key(usKSC);
-    }
-    if (castling_[usQSC] != castling_old[usQSC]) {
-        hash_ ^= zobrist::castling_key(usQSC);
-    }
-    if (castling_[themKSC] != castling_old[themKSC]) {
-        hash_ ^= zobrist::castling_key(themKSC);
-    }
-    if (castling_[themQSC] != castling_old[themQSC]) {
-        hash_ ^= zobrist::castling_key(themQSC);
-    }
+    hash_ ^= zobrist::castling_rights_key(castling_old ^ castling_);
 #endif
 
     // Swap sides
@@ -323,4 +354,38 @@ void Position::makemove(const Move &move) noexcept {
     assert(valid());
 }
 
+template <Side Us>
+void Position::update_keys([[maybe_unused]] const Move &move) noexcept {
+#ifndef NO_HASH
+    constexpr auto them = !Us;
+    const auto to = move.to();
+    const auto piece = move.piece();
+    const auto captured = move.captured();
+    const auto promo = move.promotion();
+
+    if (piece == Piece::Pawn) {
+        pawn_hash_ ^= zobrist::piece_key(Piece::Pawn, Us, move.from());
+        if (promo == Piece::None) {
+            pawn_hash_ ^= zobrist::piece_key(Piece::Pawn, Us, to);
+        }
+    }
+
+    if (captured != Piece::None) {
+        if (captured == Piece::Pawn) {
+            const auto sq = move.type() != MoveType::enpassant ? to : Us == Side::White ? to.south() : to.north();
+            pawn_hash_ ^= zobrist::piece_key(Piece::Pawn, them, sq);
+        }
+        material_hash_ ^= zobrist::piece_key(captured, them, Square{piece_count(them, captured) - 1});
+    }
+
+    if (promo != Piece::None) {
+        material_hash_ ^= zobrist::piece_key(Piece::Pawn, Us, Square{piece_count(Us, Piece::Pawn) - 1});
+        material_hash_ ^= zobrist::piece_key(promo, Us, Square{piece_count(Us, promo)});
+    }
+#endif
+}
+
+template void Position::update_keys<Side::White>(const Move &move) noexcept;
+template void Position::update_keys<Side::Black>(const Move &move) noexcept;
+
 }  // namespace libchess
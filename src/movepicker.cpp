@@ -0,0 +1,103 @@
+#include "libchess/movepicker.hpp"
+#include <cstdlib>
+#include <utility>
+
+namespace libchess {
+
+namespace {
+
+// Most valuable victim, least valuable attacker, with promotions on top
+[[nodiscard]] constexpr int capture_score(const Move &move) noexcept {
+    return 16 * (piece_values[move.captured()] + piece_values[move.promotion()]) - piece_values[move.piece()];
+}
+
+}  // namespace
+
+[[nodiscard]] bool MovePicker::refutation(const Move &move) const noexcept {
+    return move == hash_move_ || move == refutations_[0] || move == refutations_[1] || move == refutations_[2];
+}
+
+[[nodiscard]] bool MovePicker::next(Move &move) noexcept {
+    switch (stage_) {
+        case Stage::HashMove:
+            stage_ = Stage::GenerateCaptures;
+            if (hash_move_ && pos_.is_legal(hash_move_)) {
+                move = hash_move_;
+                return true;
+            }
+            hash_move_ = Move{};
+            [[fallthrough]];
+        case Stage::GenerateCaptures:
+            pos_.legal_captures(moves_);
+            for (std::size_t i = 0; i < moves_.size(); ++i) {
+                scores_[i] = capture_score(moves_[i]);
+            }
+            idx_ = 0;
+            stage_ = Stage::Captures;
+            [[fallthrough]];
+        case Stage::Captures:
+            while (idx_ < moves_.size()) {
+                // Selection sort one move at a time, most cut nodes only look at the first few
+                std::size_t best = idx_;
+                for (std::size_t i = idx_ + 1; i < moves_.size(); ++i) {
+                    if (scores_[i] > scores_[best]) {
+                        best = i;
+                    }
+                }
+                std::swap(moves_[idx_], moves_[best]);
+                std::swap(scores_[idx_], scores_[best]);
+
+                const auto candidate = moves_[idx_++];
+                if (candidate != hash_move_) {
+                    move = candidate;
+                    return true;
+                }
+            }
+            if (skip_quiets_) {
+                stage_ = Stage::Done;
+                return false;
+            }
+            stage_ = Stage::Killer1;
+            [[fallthrough]];
+        case Stage::Killer1:
+        case Stage::Killer2:
+        case Stage::Counter:
+            while (stage_ != Stage::GenerateQuiets) {
+                const auto n = static_cast<int>(stage_) - static_cast<int>(Stage::Killer1);
+                const auto candidate = refutations_[n];
+                stage_ = static_cast<Stage>(static_cast<int>(stage_) + 1);
+
+                // Captures were already handed out, and skip anything that's been tried already
+                const bool repeat = candidate == hash_move_ || (n > 0 && candidate == refutations_[0]) ||
+                                    (n > 1 && candidate == refutations_[1]);
+                if (candidate && !candidate.is_capturing() && !repeat && pos_.is_legal(candidate)) {
+                    move = candidate;
+                    return true;
+                }
+                refutations_[n] = Move{};
+            }
+            [[fallthrough]];
+        case Stage::GenerateQuiets:
+            moves_.clear();
+            pos_.legal_noncaptures(moves_);
+            idx_ = 0;
+            stage_ = Stage::Quiets;
+            [[fallthrough]];
+        case Stage::Quiets:
+            while (idx_ < moves_.size()) {
+                const auto candidate = moves_[idx_++];
+                if (!refutation(candidate)) {
+                    move = candidate;
+                    return true;
+                }
+            }
+            stage_ = Stage::Done;
+            [[fallthrough]];
+        case Stage::Done:
+            return false;
+        default:
+            abort();
+    }
+}
+
+}  // namespace libchess
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+[[nodiscard]] bool Position::pack(PackedPosition &packed) const noexcept {
+    if (occupied().count() > 32) {
+        return false;
+    }
+
+    packed = PackedPosition{};
+    packed.occupied = occupied().value();
+
+    // Two squares per byte
+    const auto black = occupancy(Side::Black).value();
+    auto bb = occupied().value();
+    for (auto &byte : packed.pieces) {
+        if (!bb) {
+            break;
+        }
+        const auto lo = std::countr_zero(bb);
+        bb &= bb - 1;
+        byte = static_cast<std::uint8_t>((black >> lo & 1) << 3 | mailbox_[lo]);
+        if (!bb) {
+            break;
+        }
+        const auto hi = std::countr_zero(bb);
+        bb &= bb - 1;
+        byte |= static_cast<std::uint8_t>(((black >> hi & 1) << 3 | mailbox_[hi]) << 4);
+    }
+
+    for (int n = 0; n < 4; ++n) {
+        if (castling_ & castling_bit(n < 2 ? Side::White : Side::Black, n % 2 ? MoveType::qsc : MoveType::ksc)) {
+            packed.castling |= static_cast<std::uint16_t>(1U << n);
+        }
+        packed.castling |= static_cast<std::uint16_t>(castle_rooks_from_[n].file() << (4 + 3 * n));
+    }
+
+    packed.halfmoves = static_cast<std::uint16_t>(std::min<std::size_t>(halfmove_clock_, 0xFFFF));
+
+    const auto ep_index = ep_ == squares::OffSq ? 64U : static_cast<unsigned int>(ep_);
+    const auto fullmoves = std::min<std::size_t>(fullmove_clock_, 0xFFFFFF);
+    packed.state = static_cast<std::uint32_t>(fullmoves << 8 | ep_index << 1 | (turn() == Side::Black));
+
+    return true;
+}
+
+[[nodiscard]] bool Position::unpack(const PackedPosition &packed) noexcept {
+    // Everything is checked before the position is touched, the bytes may have come from anywhere
+    if (Bitboard{packed.occupied}.count() > 32) {
+        return false;
+    }
+
+    Bitboard colour_bb[2] = {};
+    Bitboard piece_bb[6] = {};
+    auto mailbox = make_empty_mailbox();
+    int i = 0;
+    for (const auto &sq : Bitboard{packed.occupied}) {
+        const auto code = (packed.pieces[i / 2] >> (4 * (i % 2))) & 0xF;
+        const auto s = code >> 3 ? Side::Black : Side::White;
+        const auto p = static_cast<Piece>(code & 0x7);
+        if (p > Piece::King) {
+            return false;
+        }
+        colour_bb[s] |= sq;
+        piece_bb[p] |= sq;
+        mailbox[static_cast<int>(sq)] = static_cast<std::uint8_t>(p);
+        i++;
+    }
+
+    const auto turn = packed.state & 1 ? Side::Black : Side::White;
+    const auto wksq = colour_bb[Side::White] & piece_bb[Piece::King];
+    const auto bksq = colour_bb[Side::Black] & piece_bb[Piece::King];
+    if (wksq.count() != 1 || bksq.count() != 1) {
+        return false;
+    } else if (piece_bb[Piece::Pawn] & (bitboards::Rank1 | bitboards::Rank8)) {
+        return false;
+    } else if (attacked_by(colour_bb, piece_bb, (turn == Side::White ? bksq : wksq).lsb(), turn)) {
+        return false;
+    }
+
+    // A right needs the king on its back rank and a rook on the right side of it
+    std::uint8_t rights = 0;
+    std::array<Square, 4> rooks_from;
+    for (int n = 0; n < 4; ++n) {
+        const auto s = n < 2 ? Side::White : Side::Black;
+        const auto mt = n % 2 ? MoveType::qsc : MoveType::ksc;
+        const auto ksq = (s == Side::White ? wksq : bksq).lsb();
+        const auto file = (packed.castling >> (4 + 3 * n)) & 0x7;
+        rooks_from[n] = Square{file, s == Side::White ? 0 : 7};
+        const auto rook = colour_bb[s] & piece_bb[Piece::Rook] & Bitboard{rooks_from[n]};
+        if (!(packed.castling & (1U << n))) {
+            continue;
+        } else if (ksq.rank() != rooks_from[n].rank() || !rook) {
+            return false;
+        } else if (mt == MoveType::ksc ? file < ksq.file() : file > ksq.file()) {
+            return false;
+        }
+        rights |= castling_bit(s, mt);
+    }
+
+    const auto ep_index = static_cast<int>((packed.state >> 1) & 0x7F);
+    if (ep_index > 64 || (ep_index < 64 && Square{ep_index}.rank() != (turn == Side::White ? 5 : 2))) {
+        return false;
+    }
+
+    clear();
+
+    colours_[0] = colour_bb[0];
+    colours_[1] = colour_bb[1];
+    for (int n = 0; n < 6; ++n) {
+        pieces_[n] = piece_bb[n];
+    }
+    mailbox_ = mailbox;
+
+    to_move_ = turn;
+
+    castling_ = rights;
+    castle_rooks_from_ = rooks_from;
+    set_castling_mask();
+
+    ep_ = ep_index == 64 ? squares::OffSq : Square{ep_index};
+    halfmove_clock_ = packed.halfmoves;
+    fullmove_clock_ = packed.state >> 8;
+
+    set_keys();
+
+    assert(valid());
+    return true;
+}
+
+}  // namespace libchess
@@ -0,0 +1,109 @@
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+namespace {
+
+[[nodiscard]] bool parse_square(const char file, const char rank, Square &sq) noexcept {
+    if (file < 'a' || 'h' < file || rank < '1' || '8' < rank) {
+        return false;
+    }
+    sq = Square{file - 'a', rank - '1'};
+    return true;
+}
+
+[[nodiscard]] Piece parse_promotion(const char c) noexcept {
+    switch (c) {
+        case 'n':
+            return Piece::Knight;
+        case 'b':
+            return Piece::Bishop;
+        case 'r':
+            return Piece::Rook;
+        case 'q':
+            return Piece::Queen;
+        default:
+            return Piece::None;
+    }
+}
+
+}  // namespace
+
+// Fills in the move type, piece and captured piece from the board, castling isn't handled here
+// The move still has to be checked with is_legal(), only the combinations a Move can't hold are rejected
+[[nodiscard]] Move Position::candidate_move(const Square from, const Square to, const Piece promo) const noexcept {
+    const auto piece = piece_on(from);
+    const auto captured = piece_on(to);
+
+    if (from == to || piece == Piece::None || captured == Piece::King ||
+        (promo != Piece::None && (piece != Piece::Pawn || captured == Piece::Pawn))) {
+        return {};
+    }
+
+    if (piece == Piece::Pawn) {
+        const auto diagonal = from.file() != to.file();
+        if (promo != Piece::None) {
+            return captured == Piece::None ? Move(MoveType::promo, from, to, piece, Piece::None, promo)
+                                           : Move(MoveType::promo_capture, from, to, piece, captured, promo);
+        } else if (diagonal && to == ep()) {
+            return Move(MoveType::enpassant, from, to, piece, Piece::Pawn);
+        } else if (!diagonal && (to.rank() - from.rank() == 2 || from.rank() - to.rank() == 2)) {
+            return Move(MoveType::Double, from, to, piece);
+        }
+    }
+
+    return captured == Piece::None ? Move(MoveType::Normal, from, to, piece)
+                                   : Move(MoveType::Capture, from, to, piece, captured);
+}
+
+// The move is built from the board and then checked with is_legal(), so no move list is generated
+// Castling is accepted both as the king's two square step and as king takes rook
+[[nodiscard]] Move Position::try_parse_move(const std::string_view str) const noexcept {
+    if (str.size() != 4 && str.size() != 5) {
+        return {};
+    }
+
+    Square from;
+    Square to;
+    if (!parse_square(str[0], str[1], from) || !parse_square(str[2], str[3], to) || from == to) {
+        return {};
+    }
+
+    const auto promo = str.size() == 5 ? parse_promotion(str[4]) : Piece::None;
+    if (str.size() == 5 && promo == Piece::None) {
+        return {};
+    }
+
+    const auto us = turn();
+    if (!(occupancy(us) & Bitboard{from})) {
+        return {};
+    }
+
+    auto move = Move{};
+
+    if (piece_on(from) == Piece::King && promo == Piece::None) {
+        const auto home = us == Side::White ? squares::E1 : squares::E8;
+        const auto ksc_to = us == Side::White ? squares::G1 : squares::G8;
+        const auto qsc_to = us == Side::White ? squares::C1 : squares::C8;
+
+        if (pieces(us, Piece::Rook) & Bitboard{to}) {
+            // King takes rook
+            const auto mt = to.file() > from.file() ? MoveType::ksc : MoveType::qsc;
+            move = Move(mt, from, to, Piece::King);
+        } else if (from == home && (to == ksc_to || to == qsc_to)) {
+            // Two square step, in Chess960 the rook may already be on the destination square which was handled above
+            const auto mt = to == ksc_to ? MoveType::ksc : MoveType::qsc;
+            if (can_castle(us, mt)) {
+                move = Move(mt, from, get_castling_square(us, mt), Piece::King);
+            }
+        }
+    }
+
+    if (!move) {
+        move = candidate_move(from, to, promo);
+    }
+
+    return is_legal(move) ? move : Move{};
+}
+
+}  // namespace libchess
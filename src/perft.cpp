@@ -1,3 +1,10 @@
+#include "libchess/perft.hpp"
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "libchess/position.hpp"
 
 namespace libchess {
@@ -11,7 +18,8 @@ namespace libchess {
 
     std::uint64_t nodes = 0;
 
-    const auto moves = legal_moves();
+    MoveList moves;
+    legal_moves(moves);
     for (const auto &move : moves) {
         makemove(move);
         nodes += perft(depth - 1);
@@ -21,4 +29,135 @@ namespace libchess {
     return nodes;
 }
 
+namespace {
+
+// Moves from the root down to where a task starts
+using Task = std::vector<Move>;
+
+class TaskQueue {
+   public:
+    void push(const std::size_t idx) {
+        const std::lock_guard lock{mutex_};
+        tasks_.push_back(idx);
+    }
+
+    // The owner works from the back
+    [[nodiscard]] bool pop(std::size_t &idx) {
+        const std::lock_guard lock{mutex_};
+        if (tasks_.empty()) {
+            return false;
+        }
+        idx = tasks_.back();
+        tasks_.pop_back();
+        return true;
+    }
+
+    // Other threads steal from the front
+    [[nodiscard]] bool steal(std::size_t &idx) {
+        const std::lock_guard lock{mutex_};
+        if (tasks_.empty()) {
+            return false;
+        }
+        idx = tasks_.front();
+        tasks_.pop_front();
+        return true;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::deque<std::size_t> tasks_;
+};
+
+// Expand the root until there are enough tasks to keep every thread busy, always leaving a few plies for each task
+[[nodiscard]] std::vector<Task> split_tree(Position pos, const int depth, const int threads, int &split) {
+    const auto min_tasks = static_cast<std::size_t>(threads) * 64;
+    std::vector<Task> tasks = {Task{}};
+    split = 0;
+
+    while (split < depth - 2 && tasks.size() < min_tasks) {
+        std::vector<Task> next;
+        for (const auto &task : tasks) {
+            for (const auto &move : task) {
+                pos.makemove(move);
+            }
+
+            MoveList moves;
+            pos.legal_moves(moves);
+            for (const auto &move : moves) {
+                next.push_back(task);
+                next.back().push_back(move);
+            }
+
+            for (std::size_t i = 0; i < task.size(); ++i) {
+                pos.undomove();
+            }
+        }
+        tasks = std::move(next);
+        split++;
+    }
+
+    return tasks;
+}
+
+}  // namespace
+
+[[nodiscard]] std::uint64_t perft_parallel(const Position &pos, const int depth, const int threads) {
+    if (threads <= 1 || depth <= 2) {
+        auto copy = pos;
+        return copy.perft(depth);
+    }
+
+    int split = 0;
+    const auto tasks = split_tree(pos, depth, threads, split);
+    const auto num_threads = static_cast<std::size_t>(threads);
+
+    std::vector<TaskQueue> queues(num_threads);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        queues[i % num_threads].push(i);
+    }
+
+    // No task ever creates more work, so a thread can stop once every queue is empty
+    std::vector<std::uint64_t> nodes(num_threads, 0);
+    const auto worker = [&](const std::size_t id) {
+        auto local = pos;
+        std::uint64_t count = 0;
+        std::size_t idx = 0;
+
+        while (true) {
+            bool found = queues[id].pop(idx);
+            for (std::size_t i = 1; !found && i < num_threads; ++i) {
+                found = queues[(id + i) % num_threads].steal(idx);
+            }
+            if (!found) {
+                break;
+            }
+
+            for (const auto &move : tasks[idx]) {
+                local.makemove(move);
+            }
+            count += local.perft(depth - split);
+            for (std::size_t i = 0; i < tasks[idx].size(); ++i) {
+                local.undomove();
+            }
+        }
+
+        nodes[id] = count;
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < num_threads; ++i) {
+        workers.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto &t : workers) {
+        t.join();
+    }
+
+    std::uint64_t total = 0;
+    for (const auto n : nodes) {
+        total += n;
+    }
+    return total;
+}
+
 }  // namespace libchess
@@ -5,10 +5,13 @@
 namespace libchess {
 
 [[nodiscard]] Bitboard Position::pinned() const noexcept {
-    return pinned(turn(), king_position(turn()));
+    return state().pinned_diagonal | state().pinned_orthogonal;
 }
 
 [[nodiscard]] Bitboard Position::pinned(const Side s) const noexcept {
+    if (s == turn()) {
+        return pinned();
+    }
     return pinned(s, king_position(s));
 }
 
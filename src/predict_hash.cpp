@@ -70,21 +70,8 @@ namespace libchess {
             abort();
     }
 
-    if (can_castle(Side::White, MoveType::ksc) && (to == squares::H1 || from == squares::E1 || from == squares::H1)) {
-        new_hash ^= zobrist::castling_key(usKSC);
-    }
-
-    if (can_castle(Side::White, MoveType::qsc) && (to == squares::A1 || from == squares::E1 || from == squares::A1)) {
-        new_hash ^= zobrist::castling_key(usQSC);
-    }
-
-    if (can_castle(Side::Black, MoveType::ksc) && (to == squares::H8 || from == squares::E8 || from == squares::H8)) {
-        new_hash ^= zobrist::castling_key(themKSC);
-    }
-
-    if (can_castle(Side::Black, MoveType::qsc) && (to == squares::A8 || from == squares::E8 || from == squares::A8)) {
-        new_hash ^= zobrist::castling_key(themQSC);
-    }
+    const auto castling_new = castling_ & castling_mask_[static_cast<int>(from)] & castling_mask_[static_cast<int>(to)];
+    new_hash ^= zobrist::castling_rights_key(castling_ ^ castling_new);
 
     return new_hash;
 #endif
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+namespace {
+
+constexpr char piece_chars[] = {'P', 'N', 'B', 'R', 'Q', 'K'};
+
+[[nodiscard]] Piece parse_piece(const char c) noexcept {
+    switch (c) {
+        case 'N':
+            return Piece::Knight;
+        case 'B':
+            return Piece::Bishop;
+        case 'R':
+            return Piece::Rook;
+        case 'Q':
+            return Piece::Queen;
+        case 'K':
+            return Piece::King;
+        default:
+            return Piece::None;
+    }
+}
+
+[[nodiscard]] bool is_file(const char c) noexcept {
+    return 'a' <= c && c <= 'h';
+}
+
+[[nodiscard]] bool is_rank(const char c) noexcept {
+    return '1' <= c && c <= '8';
+}
+
+// Everything but the check suffix, others are the squares of any other piece of the same type that can legally
+// move to the same square
+char *write_san_move(char *out, const Move &move, const Bitboard others) noexcept {
+    if (move.type() == MoveType::ksc || move.type() == MoveType::qsc) {
+        *out++ = 'O';
+        *out++ = '-';
+        *out++ = 'O';
+        if (move.type() == MoveType::qsc) {
+            *out++ = '-';
+            *out++ = 'O';
+        }
+        return out;
+    }
+
+    const auto from = move.from();
+    const auto to = move.to();
+
+    if (move.piece() == Piece::Pawn) {
+        // Pawn captures always name the file they come from
+        if (move.is_capturing()) {
+            *out++ = static_cast<char>('a' + from.file());
+            *out++ = 'x';
+        }
+    } else {
+        *out++ = piece_chars[move.piece()];
+
+        // The file is enough unless another piece shares it, then the rank, and only if both are shared the square
+        if (others) {
+            if (!(others & bitboards::files[from.file()])) {
+                *out++ = static_cast<char>('a' + from.file());
+            } else if (!(others & bitboards::ranks[from.rank()])) {
+                *out++ = static_cast<char>('1' + from.rank());
+            } else {
+                *out++ = static_cast<char>('a' + from.file());
+                *out++ = static_cast<char>('1' + from.rank());
+            }
+        }
+
+        if (move.captured() != Piece::None) {
+            *out++ = 'x';
+        }
+    }
+
+    *out++ = static_cast<char>('a' + to.file());
+    *out++ = static_cast<char>('1' + to.rank());
+
+    if (move.promotion() != Piece::None) {
+        *out++ = '=';
+        *out++ = piece_chars[move.promotion()];
+    }
+
+    return out;
+}
+
+// Only called for moves that give check, scratch has the board the move is from and is left as it was
+[[nodiscard]] bool is_mate(Position &scratch, const Move &move) noexcept {
+    scratch.makemove(move);
+    const auto mate = !scratch.has_legal_move();
+    scratch.undomove();
+    return mate;
+}
+
+}  // namespace
+
+[[nodiscard]] Move Position::try_parse_san(std::string_view str) const noexcept {
+    const auto us = turn();
+
+    // Check, mate and annotation suffixes
+    while (!str.empty() && (str.back() == '+' || str.back() == '#' || str.back() == '!' || str.back() == '?')) {
+        str.remove_suffix(1);
+    }
+
+    if (str == "O-O" || str == "O-O-O" || str == "0-0" || str == "0-0-0") {
+        const auto mt = str.size() == 3 ? MoveType::ksc : MoveType::qsc;
+        if (!can_castle(us, mt)) {
+            return {};
+        }
+        const auto move = Move(mt, king_position(us), get_castling_square(us, mt), Piece::King);
+        return is_legal(move) ? move : Move{};
+    }
+
+    // Promotion, the = is optional
+    auto promo = Piece::None;
+    if (!str.empty() && parse_piece(str.back()) != Piece::None) {
+        promo = parse_piece(str.back());
+        str.remove_suffix(1);
+        if (!str.empty() && str.back() == '=') {
+            str.remove_suffix(1);
+        }
+    }
+
+    // Destination square
+    if (str.size() < 2 || !is_file(str[str.size() - 2]) || !is_rank(str.back())) {
+        return {};
+    }
+    const auto to = Square{str[str.size() - 2] - 'a', str.back() - '1'};
+    str.remove_suffix(2);
+
+    // Capture mark
+    if (!str.empty() && str.back() == 'x') {
+        str.remove_suffix(1);
+    }
+
+    // Piece, pawns have no letter
+    auto piece = Piece::Pawn;
+    if (!str.empty() && parse_piece(str.front()) != Piece::None) {
+        piece = parse_piece(str.front());
+        str.remove_prefix(1);
+    }
+
+    // Disambiguation
+    int from_file = -1;
+    auto filter = ~Bitboard{};
+    if (!str.empty() && is_file(str.front())) {
+        from_file = str.front() - 'a';
+        filter &= bitboards::files[from_file];
+        str.remove_prefix(1);
+    }
+    if (!str.empty() && is_rank(str.front())) {
+        filter &= bitboards::ranks[str.front() - '1'];
+        str.remove_prefix(1);
+    }
+
+    if (!str.empty() || promo == Piece::King || (promo != Piece::None && piece != Piece::Pawn)) {
+        return {};
+    }
+
+    // Pieces that could reach the square, only pawns need more than the attack bitboards
+    Bitboard candidates;
+    if (piece == Piece::Pawn) {
+        const auto to_bb = Bitboard{to};
+        const auto behind = us == Side::White ? to_bb.south() : to_bb.north();
+        if (from_file != -1 && from_file != to.file()) {
+            candidates = behind.east() | behind.west();
+        } else if (behind & occupied()) {
+            candidates = behind;
+        } else {
+            candidates = behind | (us == Side::White ? behind.south() : behind.north());
+        }
+        candidates &= pieces(us, Piece::Pawn);
+    } else {
+        candidates = attackers(to, us) & pieces(us, piece);
+    }
+
+    // Exactly one of them has to be legal
+    auto found = Move{};
+    for (const auto &sq : candidates & filter) {
+        const auto move = candidate_move(sq, to, promo);
+        if (is_legal(move)) {
+            if (found) {
+                return {};
+            }
+            found = move;
+        }
+    }
+
+    return found;
+}
+
+char *Position::write_san(char *out, const Move &move) const noexcept {
+    Bitboard others;
+    if (move.piece() != Piece::Pawn && move.piece() != Piece::King) {
+        for (const auto &sq : attackers(move.to(), turn()) & pieces(turn(), move.piece()) & ~Bitboard{move.from()}) {
+            if (is_legal(candidate_move(sq, move.to(), Piece::None))) {
+                others |= Bitboard{sq};
+            }
+        }
+    }
+
+    out = write_san_move(out, move, others);
+
+    if (gives_check(move)) {
+        Position scratch;
+        scratch.assign_without_history(*this);
+        *out++ = is_mate(scratch, move) ? '#' : '+';
+    }
+
+    return out;
+}
+
+void Position::write_san(const MoveList &moves, SanString *out) const noexcept {
+    // Moves are grouped by piece and destination square to find the ambiguous ones, only the entries used get set
+    std::array<std::uint64_t, 6 * 64> froms;
+    const auto key = [](const Move &move) {
+        return move.piece() * 64 + static_cast<int>(move.to());
+    };
+
+    for (const auto &move : moves) {
+        froms[key(move)] = 0;
+    }
+    for (const auto &move : moves) {
+        if (move.type() != MoveType::ksc && move.type() != MoveType::qsc) {
+            froms[key(move)] |= Bitboard{move.from()}.value();
+        }
+    }
+
+    // Set up the first time a move gives check, every checking move after that is made and unmade on it
+    Position scratch;
+    bool have_scratch = false;
+
+    for (const auto &move : moves) {
+        auto others = Bitboard{};
+        if (move.piece() != Piece::Pawn && move.type() != MoveType::ksc && move.type() != MoveType::qsc) {
+            others = Bitboard{froms[key(move)]} & ~Bitboard{move.from()};
+        }
+
+        auto end = write_san_move(out->data(), move, others);
+        if (gives_check(move)) {
+            if (!have_scratch) {
+                scratch.assign_without_history(*this);
+                have_scratch = true;
+            }
+            *end++ = is_mate(scratch, move) ? '#' : '+';
+        }
+        *end = '\0';
+        out++;
+    }
+}
+
+void Position::assign_without_history(const Position &other) noexcept {
+    std::copy(std::begin(other.colours_), std::end(other.colours_), std::begin(colours_));
+    std::copy(std::begin(other.pieces_), std::end(other.pieces_), std::begin(pieces_));
+    mailbox_ = other.mailbox_;
+    halfmove_clock_ = other.halfmove_clock_;
+    fullmove_clock_ = other.fullmove_clock_;
+    ep_ = other.ep_;
+    hash_ = other.hash_;
+    pawn_hash_ = other.pawn_hash_;
+    material_hash_ = other.material_hash_;
+    non_pawn_material_ = other.non_pawn_material_;
+    castling_ = other.castling_;
+    castling_mask_ = other.castling_mask_;
+    castle_rooks_from_ = other.castle_rooks_from_;
+    to_move_ = other.to_move_;
+    history_.clear();
+    history_.reserve(1);
+    state_ = other.state_;
+    state_valid_ = other.state_valid_;
+    check_info_ = other.check_info_;
+    check_info_valid_ = other.check_info_valid_;
+    known_checkers_ = other.known_checkers_;
+    known_checkers_valid_ = other.known_checkers_valid_;
+}
+
+}  // namespace libchess
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include "libchess/movegen.hpp"
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+namespace {
+
+struct Pins {
+    Bitboard blockers;
+    Bitboard pinners;
+};
+
+// Pieces of side s that are the only thing between their king and an enemy slider
+[[nodiscard]] Pins find_pins(const Position &pos, const Side s) noexcept {
+    const auto ksq = pos.king_position(s);
+    const auto bq = pos.pieces(!s, Piece::Bishop) | pos.pieces(!s, Piece::Queen);
+    const auto rq = pos.pieces(!s, Piece::Rook) | pos.pieces(!s, Piece::Queen);
+    const auto snipers = (movegen::bishop_moves(ksq, Bitboard{}) & bq) | (movegen::rook_moves(ksq, Bitboard{}) & rq);
+    Pins pins;
+
+    for (const auto &sq : snipers) {
+        const auto between = squares_between(ksq, sq) & pos.occupied();
+        if (between.count() == 1 && (between & pos.occupancy(s))) {
+            pins.blockers |= between;
+            pins.pinners |= Bitboard{sq};
+        }
+    }
+
+    return pins;
+}
+
+// Attackers of both sides on sq, given the occupancy left over from the exchange so far
+[[nodiscard]] Bitboard attackers_to(const Position &pos, const Square sq, const Bitboard occ) noexcept {
+    const auto bb = Bitboard{sq};
+    const auto bq = pos.occupancy(Piece::Bishop) | pos.occupancy(Piece::Queen);
+    const auto rq = pos.occupancy(Piece::Rook) | pos.occupancy(Piece::Queen);
+    return (pos.pieces(Side::White, Piece::Pawn) & (bb.south().east() | bb.south().west())) |
+           (pos.pieces(Side::Black, Piece::Pawn) & (bb.north().east() | bb.north().west())) |
+           (movegen::knight_moves(sq) & pos.occupancy(Piece::Knight)) | (movegen::bishop_moves(sq, occ) & bq) |
+           (movegen::rook_moves(sq, occ) & rq) | (movegen::king_moves(sq) & pos.occupancy(Piece::King));
+}
+
+}  // namespace
+
+// Swap algorithm: both sides take turns recapturing on the destination square with their least valuable attacker,
+// then the list of gains is minimaxed backwards since either side may stop capturing whenever it's ahead
+[[nodiscard]] int Position::see(const Move &move) const noexcept {
+    if (move.type() == MoveType::ksc || move.type() == MoveType::qsc) {
+        return 0;
+    }
+
+    const auto from = move.from();
+    const auto to = move.to();
+    const auto to_bb = Bitboard{to};
+    const auto bq = occupancy(Piece::Bishop) | occupancy(Piece::Queen);
+    const auto rq = occupancy(Piece::Rook) | occupancy(Piece::Queen);
+    const auto promo_ranks = bitboards::Rank1 | bitboards::Rank8;
+    const std::array<Pins, 2> pins = {{find_pins(*this, Side::White), find_pins(*this, Side::Black)}};
+
+    auto occ = occupied() ^ Bitboard{from} ^ (occupied() & to_bb);
+    if (move.type() == MoveType::enpassant) {
+        occ ^= turn() == Side::White ? to_bb.south() : to_bb.north();
+    }
+
+    std::array<int, 32> gain;
+    int d = 0;
+    gain[0] = piece_values[move.captured()];
+    int on_square = piece_values[move.piece()];
+    if (move.promotion() != Piece::None) {
+        gain[0] += piece_values[move.promotion()] - piece_values[Piece::Pawn];
+        on_square = piece_values[move.promotion()];
+    }
+
+    // A pinned piece can still recapture along its pin line, or once the pinner has left the board
+    const auto can_recapture = [&](const Side s, const Bitboard candidates) {
+        auto allowed = candidates & ~pins[s].blockers;
+        const auto ksq = king_position(s);
+        for (const auto &sq : candidates & pins[s].blockers) {
+            const auto bb = Bitboard{sq};
+            const auto on_line = (squares_between(ksq, to) & bb) || (squares_between(ksq, sq) & to_bb);
+            bool pinned = false;
+            for (const auto &pinner : pins[s].pinners & occ) {
+                pinned |= bool(squares_between(ksq, pinner) & bb);
+            }
+            if (on_line || !pinned) {
+                allowed |= bb;
+            }
+        }
+        return allowed;
+    };
+
+    auto attackers = attackers_to(*this, to, occ) & occ;
+    auto stm = turn();
+
+    while (d + 1 < static_cast<int>(gain.size())) {
+        stm = !stm;
+        const auto our_attackers = can_recapture(stm, attackers & occupancy(stm));
+        if (!our_attackers) {
+            break;
+        }
+
+        auto piece = Piece::None;
+        for (const auto p : libchess::pieces) {
+            if (our_attackers & occupancy(p)) {
+                piece = p;
+                break;
+            }
+        }
+        assert(piece != Piece::None);
+
+        // The king can only recapture if nothing is left to take it back
+        if (piece == Piece::King && (attackers & occupancy(!stm))) {
+            break;
+        }
+
+        d++;
+        gain[d] = on_square - gain[d - 1];
+        on_square = piece_values[piece];
+        if (piece == Piece::Pawn && (to_bb & promo_ranks)) {
+            gain[d] += piece_values[Piece::Queen] - piece_values[Piece::Pawn];
+            on_square = piece_values[Piece::Queen];
+        }
+
+        // Sliders lined up behind the attacker join in
+        occ ^= Bitboard{(our_attackers & occupancy(piece)).lsb()};
+        attackers |= (movegen::bishop_moves(to, occ) & bq) | (movegen::rook_moves(to, occ) & rq);
+        attackers &= occ;
+    }
+
+    while (d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        d--;
+    }
+
+    return gain[0];
+}
+
+[[nodiscard]] bool Position::see_ge(const Move &move, const int threshold) const noexcept {
+    // Most captures are settled by the first one or two captures, unless a recapturing pawn can promote
+    if (move.type() != MoveType::ksc && move.type() != MoveType::qsc &&
+        !(Bitboard{move.to()} & (bitboards::Rank1 | bitboards::Rank8))) {
+        const auto first = piece_values[move.captured()];
+        if (first < threshold) {
+            return false;
+        }
+        if (first - piece_values[move.piece()] >= threshold) {
+            return true;
+        }
+    }
+    return see(move) >= threshold;
+}
+
+}  // namespace libchess
@@ -1,213 +1,303 @@
+#include <array>
 #include <cassert>
-#include <sstream>
+#include <cstdint>
+#include <string_view>
 #include "libchess/position.hpp"
 
 namespace libchess {
 
+namespace {
+
+[[nodiscard]] bool is_space(const char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Moves pos past the next whitespace separated field, returns false once there are no fields left
+[[nodiscard]] bool next_field(const std::string_view str,
+                              std::size_t &pos,
+                              std::string_view &field,
+                              std::size_t &offset) {
+    while (pos < str.size() && is_space(str[pos])) {
+        pos++;
+    }
+    offset = pos;
+    while (pos < str.size() && !is_space(str[pos])) {
+        pos++;
+    }
+    field = str.substr(offset, pos - offset);
+    return !field.empty();
+}
+
+// Digits only, no sign, up to the limit
+[[nodiscard]] bool parse_number(const std::string_view str, const std::size_t limit, std::size_t &n) noexcept {
+    n = 0;
+    for (const auto c : str) {
+        if (c < '0' || '9' < c) {
+            return false;
+        }
+        n = 10 * n + static_cast<std::size_t>(c - '0');
+        if (n > limit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Piece letters to their index (side * 6 + piece), everything else to -1
+constexpr auto piece_codes = [] {
+    std::array<std::int8_t, 256> codes = {};
+    codes.fill(-1);
+    constexpr std::string_view letters = "PNBRQKpnbrqk";
+    for (std::size_t i = 0; i < letters.size(); ++i) {
+        codes[static_cast<unsigned char>(letters[i])] = static_cast<std::int8_t>(i);
+    }
+    return codes;
+}();
+
+}  // namespace
+
 void Position::set_fen(const std::string &fen, const bool dfrc) noexcept {
+    [[maybe_unused]] const auto error = try_set_fen(fen, dfrc);
+}
+
+[[nodiscard]] Position::FenError Position::try_set_fen(const std::string_view fen, const bool dfrc) noexcept {
     if (fen == "startpos") {
-        set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-        return;
+        return try_set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
     }
 
-    clear();
+    // Everything is checked before the position is touched, so a bad FEN leaves it as it was
+    std::size_t pos = 0;
+    std::string_view word;
+    std::size_t offset = 0;
 
-    std::stringstream ss{fen};
-    std::string word;
-
-    ss >> word;
-    int i = 56;
-    for (const auto &c : word) {
-        switch (c) {
-            case 'P':
-                set(Square(i), Side::White, Piece::Pawn);
-                i++;
-                break;
-            case 'p':
-                set(Square(i), Side::Black, Piece::Pawn);
-                i++;
-                break;
-            case 'N':
-                set(Square(i), Side::White, Piece::Knight);
-                i++;
-                break;
-            case 'n':
-                set(Square(i), Side::Black, Piece::Knight);
-                i++;
-                break;
-            case 'B':
-                set(Square(i), Side::White, Piece::Bishop);
-                i++;
-                break;
-            case 'b':
-                set(Square(i), Side::Black, Piece::Bishop);
-                i++;
-                break;
-            case 'R':
-                set(Square(i), Side::White, Piece::Rook);
-                i++;
-                break;
-            case 'r':
-                set(Square(i), Side::Black, Piece::Rook);
-                i++;
-                break;
-            case 'Q':
-                set(Square(i), Side::White, Piece::Queen);
-                i++;
-                break;
-            case 'q':
-                set(Square(i), Side::Black, Piece::Queen);
-                i++;
-                break;
-            case 'K':
-                set(Square(i), Side::White, Piece::King);
-                i++;
-                break;
-            case 'k':
-                set(Square(i), Side::Black, Piece::King);
-                i++;
-                break;
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-                i += c - '1' + 1;
-                break;
-            case '/':
-                i -= 16;
-                break;
-            default:
-                break;
+    // Piece placement
+    Bitboard colour_bb[2] = {};
+    Bitboard piece_bb[6] = {};
+    auto mailbox = make_empty_mailbox();
+    if (!next_field(fen, pos, word, offset)) {
+        return {FenError::Field::Board, offset, "Missing field"};
+    }
+    {
+        int rank = 7;
+        int file = 0;
+        for (std::size_t i = 0; i < word.size(); ++i) {
+            const auto c = word[i];
+            const auto code = piece_codes[static_cast<unsigned char>(c)];
+            if (code >= 0) {
+                const auto p = static_cast<Piece>(code % 6);
+                if (file >= 8) {
+                    return {FenError::Field::Board, offset + i, "Wrong number of squares in a rank"};
+                } else if (p == Piece::Pawn && (rank == 0 || rank == 7)) {
+                    return {FenError::Field::Board, offset + i, "Pawn on the first or last rank"};
+                }
+                const auto sq = Square(file, rank);
+                colour_bb[code / 6] |= sq;
+                piece_bb[p] |= sq;
+                mailbox[static_cast<int>(sq)] = p;
+                file++;
+            } else if ('1' <= c && c <= '8') {
+                file += c - '0';
+                if (file > 8) {
+                    return {FenError::Field::Board, offset + i, "Wrong number of squares in a rank"};
+                }
+            } else if (c == '/') {
+                if (file != 8) {
+                    return {FenError::Field::Board, offset + i, "Wrong number of squares in a rank"};
+                } else if (rank == 0) {
+                    return {FenError::Field::Board, offset + i, "Too many ranks"};
+                }
+                rank--;
+                file = 0;
+            } else {
+                return {FenError::Field::Board, offset + i, "Invalid character"};
+            }
+        }
+        if (file != 8) {
+            return {FenError::Field::Board, offset + word.size(), "Wrong number of squares in a rank"};
+        } else if (rank != 0) {
+            return {FenError::Field::Board, offset + word.size(), "Too few ranks"};
+        } else if ((colour_bb[0] & piece_bb[Piece::King]).count() != 1 ||
+                   (colour_bb[1] & piece_bb[Piece::King]).count() != 1) {
+            return {FenError::Field::Board, offset, "Each side needs exactly one king"};
+        } else if (colour_bb[0].count() > 16 || colour_bb[1].count() > 16) {
+            return {FenError::Field::Board, offset, "More than 16 pieces for one side"};
         }
     }
 
     // Side to move
-    ss >> word;
-    if (word == "w") {
-        to_move_ = Side::White;
-    } else {
-        to_move_ = Side::Black;
+    if (!next_field(fen, pos, word, offset)) {
+        return {FenError::Field::Turn, offset, "Missing field"};
+    } else if (word != "w" && word != "b") {
+        return {FenError::Field::Turn, offset, "Expected w or b"};
+    }
+    const auto turn = word == "w" ? Side::White : Side::Black;
+    if (attacked_by(colour_bb, piece_bb, (colour_bb[!turn] & piece_bb[Piece::King]).lsb(), turn)) {
+        return {FenError::Field::Turn, offset, "The side not to move is in check"};
     }
 
     // Castling perms
-    ss >> word;
-    if (word != "-") {
-        const auto wksq = king_position(Side::White);
-        const auto bksq = king_position(Side::Black);
-        const auto white_rooks = pieces(Side::White, libchess::Rook);
-        const auto black_rooks = pieces(Side::Black, libchess::Rook);
-
-        for (const auto &c : word) {
-            if (dfrc) {
-                // White
-                if ('A' <= c && c <= 'H') {
-                    const auto sq = Square(c - 'A');
-                    const auto is_king_side = sq.file() > wksq.file();
-                    if (is_king_side && white_rooks.get(sq)) {
-                        castling_[0] = true;
-                        castle_rooks_from_[0] = sq;
-                    } else if (!is_king_side && white_rooks.get(sq)) {
-                        castling_[1] = true;
-                        castle_rooks_from_[1] = sq;
-                    }
-                }
-                // Black
-                else if ('a' <= c && c <= 'h') {
-                    const auto sq = Square(56 + c - 'a');
-                    const auto is_king_side = sq.file() > bksq.file();
-                    if (is_king_side && black_rooks.get(sq)) {
-                        castling_[2] = true;
-                        castle_rooks_from_[2] = sq;
-                    } else if (!is_king_side && black_rooks.get(sq)) {
-                        castling_[3] = true;
-                        castle_rooks_from_[3] = sq;
-                    }
+    if (!next_field(fen, pos, word, offset)) {
+        return {FenError::Field::Castling, offset, "Missing field"};
+    }
+    const auto castling = word;
+    if (castling != "-") {
+        for (std::size_t i = 0; i < castling.size(); ++i) {
+            const auto c = castling[i];
+            // File letters are only used with dfrc but aren't malformed without it
+            const auto valid = c == 'K' || c == 'Q' || c == 'k' || c == 'q' || ('A' <= c && c <= 'H') ||
+                               ('a' <= c && c <= 'h');
+            if (!valid) {
+                return {FenError::Field::Castling, offset + i, "Invalid character"};
+            }
+        }
+    }
+
+    // Castling rights are only granted with the king on its back rank and a rook on the square named
+    std::uint8_t rights = 0;
+    std::array<Square, 4> rooks_from = {{squares::H1, squares::A1, squares::H8, squares::A8}};
+    if (castling != "-") {
+        const auto white_king = colour_bb[Side::White] & piece_bb[Piece::King];
+        const auto black_king = colour_bb[Side::Black] & piece_bb[Piece::King];
+        const auto wksq = white_king.lsb();
+        const auto bksq = black_king.lsb();
+        const auto white_rooks = colour_bb[Side::White] & piece_bb[Piece::Rook];
+        const auto black_rooks = colour_bb[Side::Black] & piece_bb[Piece::Rook];
+        const auto white_home = bool(white_king & bitboards::Rank1);
+        const auto black_home = bool(black_king & bitboards::Rank8);
+
+        // The right's index is the same in the castling mask and castle_rooks_from_
+        const auto grant = [&](const Side s, const MoveType mt, const Square sq) {
+            rights |= castling_bit(s, mt);
+            rooks_from[2 * s + (mt == MoveType::ksc ? 0 : 1)] = sq;
+        };
+
+        // The outermost rook on the king's side, as the X-FEN K and Q letters mean
+        const auto find_rook = [](const Square ksq, const Bitboard rooks, const bool east, Square &sq) {
+            bool found = false;
+            auto bb = Bitboard(ksq);
+            while (bb) {
+                bb = east ? bb.east() : bb.west();
+                if (bb & rooks) {
+                    sq = (bb & rooks).lsb();
+                    found = true;
                 }
+            }
+            return found;
+        };
+
+        for (std::size_t i = 0; i < castling.size(); ++i) {
+            const auto c = castling[i];
+            const auto white = 'A' <= c && c <= 'Z';
+            const auto home = white ? white_home : black_home;
+            const auto ksq = white ? wksq : bksq;
+            const auto rooks = white ? white_rooks : black_rooks;
+            const auto s = white ? Side::White : Side::Black;
+            const auto lower = white ? static_cast<char>(c - 'A' + 'a') : c;
+            const auto is_file = 'a' <= lower && lower <= 'h';
+
+            // File letters only mean something with dfrc
+            if (is_file && !dfrc) {
+                continue;
+            }
+
+            Square sq;
+            auto found = false;
+            if (is_file) {
+                sq = Square(lower - 'a', white ? 0 : 7);
+                found = rooks.get(sq);
+            } else if (dfrc) {
                 // This castling notation is bad and wrong
                 // Let's do the best we can
-                else if (c == 'K') {
-                    auto bb = Bitboard(wksq);
-                    while (bb) {
-                        bb = bb.east();
-
-                        if (bb & white_rooks) {
-                            castling_[0] = true;
-                            castle_rooks_from_[0] = (bb & white_rooks).lsb();
-                        }
-                    }
-                } else if (c == 'Q') {
-                    auto bb = Bitboard(wksq);
-                    while (bb) {
-                        bb = bb.west();
-
-                        if (bb & white_rooks) {
-                            castling_[1] = true;
-                            castle_rooks_from_[1] = (bb & white_rooks).lsb();
-                        }
-                    }
-                } else if (c == 'k') {
-                    auto bb = Bitboard(bksq);
-                    while (bb) {
-                        bb = bb.east();
-
-                        if (bb & black_rooks) {
-                            castling_[2] = true;
-                            castle_rooks_from_[2] = (bb & black_rooks).lsb();
-                        }
-                    }
-                } else if (c == 'q') {
-                    auto bb = Bitboard(bksq);
-                    while (bb) {
-                        bb = bb.west();
-
-                        if (bb & black_rooks) {
-                            castling_[3] = true;
-                            castle_rooks_from_[3] = (bb & black_rooks).lsb();
-                        }
-                    }
-                }
+                found = find_rook(ksq, rooks, lower == 'k', sq);
             } else {
-                if (c == 'K' && white_rooks.get(squares::H1)) {
-                    castling_[0] = true;
-                    castle_rooks_from_[0] = squares::H1;
-                } else if (c == 'Q' && white_rooks.get(squares::A1)) {
-                    castling_[1] = true;
-                    castle_rooks_from_[1] = squares::A1;
-                } else if (c == 'k' && black_rooks.get(squares::H8)) {
-                    castling_[2] = true;
-                    castle_rooks_from_[2] = squares::H8;
-                } else if (c == 'q' && black_rooks.get(squares::A8)) {
-                    castling_[3] = true;
-                    castle_rooks_from_[3] = squares::A8;
-                }
+                sq = Square(lower == 'k' ? 7 : 0, white ? 0 : 7);
+                found = rooks.get(sq);
+            }
+
+            // A right for a missing rook is dropped, as it always has been, but one with the king off its back
+            // rank can't mean anything
+            if (!home) {
+                return {FenError::Field::Castling, offset + i, "Castling right with the king off its back rank"};
+            } else if (found) {
+                grant(s, sq.file() > ksq.file() ? MoveType::ksc : MoveType::qsc, sq);
             }
         }
     }
 
     // En passant
-    ss >> word;
-    if (word != "-") {
-        ep_ = Square(word);
+    auto ep = squares::OffSq;
+    if (!next_field(fen, pos, word, offset)) {
+        return {FenError::Field::EnPassant, offset, "Missing field"};
+    } else if (word != "-") {
+        if (word.size() != 2 || word[0] < 'a' || 'h' < word[0] || (word[1] != '3' && word[1] != '6')) {
+            return {FenError::Field::EnPassant, offset, "Expected - or a square on the third or sixth rank"};
+        } else if (word[1] != (turn == Side::White ? '6' : '3')) {
+            return {FenError::Field::EnPassant, offset, "Square on the wrong rank for the side to move"};
+        }
+        ep = Square(word[0] - 'a', word[1] - '1');
     }
 
-    // Halfmove clock
-    ss >> halfmove_clock_;
+    // The move counters are optional
+    std::size_t halfmoves = 0;
+    std::size_t fullmoves = 0;
+    if (next_field(fen, pos, word, offset) && !parse_number(word, 65535, halfmoves)) {
+        return {FenError::Field::Halfmove, offset, "Expected a number up to 65535"};
+    }
+    if (next_field(fen, pos, word, offset) && !parse_number(word, 999999999, fullmoves)) {
+        return {FenError::Field::Fullmove, offset, "Expected a number"};
+    }
+    if (next_field(fen, pos, word, offset)) {
+        return {FenError::Field::Trailing, offset, "Unexpected characters after the FEN"};
+    }
 
-    // Fullmove clock
-    ss >> fullmove_clock_;
+    clear();
+
+    colours_[0] = colour_bb[0];
+    colours_[1] = colour_bb[1];
+    for (int i = 0; i < 6; ++i) {
+        pieces_[i] = piece_bb[i];
+    }
+    mailbox_ = mailbox;
+
+    to_move_ = turn;
 
-    // Calculate hash
+    castling_ = rights;
+    castle_rooks_from_ = rooks_from;
+    set_castling_mask();
+
+    ep_ = ep;
+    halfmove_clock_ = halfmoves;
+    fullmove_clock_ = fullmoves;
+
+    set_keys();
+
+    assert(valid());
+    return {};
+}
+
+void Position::set_keys() noexcept {
 #ifdef NO_HASH
     hash_ = 0;
 #else
     hash_ = calculate_hash();
+    pawn_hash_ = calculate_pawn_hash();
+    material_hash_ = calculate_material_hash();
 #endif
+    non_pawn_material_[Side::White] = calculate_non_pawn_material(Side::White);
+    non_pawn_material_[Side::Black] = calculate_non_pawn_material(Side::Black);
+}
 
-    assert(valid());
+void Position::set_castling_mask() noexcept {
+    castling_mask_ = make_castling_mask();
+    for (const auto s : {Side::White, Side::Black}) {
+        if (!pieces(s, Piece::King)) {
+            continue;
+        }
+        for (const auto mt : {MoveType::ksc, MoveType::qsc}) {
+            castling_mask_[static_cast<int>(king_position(s))] &= ~castling_bit(s, mt);
+            castling_mask_[static_cast<int>(get_castling_square(s, mt))] &= ~castling_bit(s, mt);
+        }
+    }
 }
 
 }  // namespace libchess
@@ -7,4 +7,20 @@ namespace libchess {
     return !attackers(sq, s).empty();
 }
 
+[[nodiscard]] bool Position::attacked_by(const Bitboard *colour_bb,
+                                         const Bitboard *piece_bb,
+                                         const Square sq,
+                                         const Side s) noexcept {
+    const auto bb = Bitboard{sq};
+    const auto occ = colour_bb[Side::White] | colour_bb[Side::Black];
+    const auto pawn_squares =
+        s == Side::White ? bb.south().east() | bb.south().west() : bb.north().east() | bb.north().west();
+    const auto bq = piece_bb[Piece::Bishop] | piece_bb[Piece::Queen];
+    const auto rq = piece_bb[Piece::Rook] | piece_bb[Piece::Queen];
+    const auto attacking = (pawn_squares & piece_bb[Piece::Pawn]) | (movegen::king_moves(sq) & piece_bb[Piece::King]) |
+                           (movegen::knight_moves(sq) & piece_bb[Piece::Knight]) |
+                           (movegen::bishop_moves(sq, occ) & bq) | (movegen::rook_moves(sq, occ) & rq);
+    return bool(attacking & colour_bb[s]);
+}
+
 }  // namespace libchess
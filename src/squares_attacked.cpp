@@ -4,43 +4,55 @@
 namespace libchess {
 
 [[nodiscard]] Bitboard Position::squares_attacked(const Side s) const noexcept {
+    if (s == Side::White) {
+        return squares_attacked<Side::White>();
+    } else {
+        return squares_attacked<Side::Black>();
+    }
+}
+
+template <Side S>
+[[nodiscard]] Bitboard Position::squares_attacked() const noexcept {
     Bitboard mask;
 
     // Pawns
-    if (s == Side::White) {
-        const auto pawns = pieces(s, Piece::Pawn);
+    if constexpr (S == Side::White) {
+        const auto pawns = pieces(S, Piece::Pawn);
         mask |= pawns.north().east();
         mask |= pawns.north().west();
     } else {
-        const auto pawns = pieces(s, Piece::Pawn);
+        const auto pawns = pieces(S, Piece::Pawn);
         mask |= pawns.south().east();
         mask |= pawns.south().west();
     }
 
     // Knights
-    for (const auto &fr : pieces(s, Piece::Knight)) {
+    for (const auto &fr : pieces(S, Piece::Knight)) {
         mask |= movegen::knight_moves(fr);
     }
 
     // Bishops
-    for (const auto &fr : pieces(s, Piece::Bishop)) {
+    for (const auto &fr : pieces(S, Piece::Bishop)) {
         mask |= movegen::bishop_moves(fr, ~empty());
     }
 
     // Rooks
-    for (const auto &fr : pieces(s, Piece::Rook)) {
+    for (const auto &fr : pieces(S, Piece::Rook)) {
         mask |= movegen::rook_moves(fr, ~empty());
     }
 
     // Queens
-    for (const auto &fr : pieces(s, Piece::Queen)) {
+    for (const auto &fr : pieces(S, Piece::Queen)) {
         mask |= movegen::queen_moves(fr, ~empty());
     }
 
     // King
-    mask |= movegen::king_moves(king_position(s));
+    mask |= movegen::king_moves(king_position(S));
 
     return mask;
 }
 
+template Bitboard Position::squares_attacked<Side::White>() const noexcept;
+template Bitboard Position::squares_attacked<Side::Black>() const noexcept;
+
 }  // namespace libchess
@@ -0,0 +1,60 @@
+#include <cassert>
+#include "libchess/movegen.hpp"
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+[[nodiscard]] Position::StateInfo Position::calculate_state(const Side s) const noexcept {
+    return calculate_state(s, attackers(king_position(s), !s));
+}
+
+[[nodiscard]] Position::StateInfo Position::calculate_state(const Side s, const Bitboard checkers) const noexcept {
+    assert(checkers == attackers(king_position(s), !s));
+    if (s == Side::White) {
+        return calculate_state<Side::White>(checkers);
+    } else {
+        return calculate_state<Side::Black>(checkers);
+    }
+}
+
+template <Side S>
+[[nodiscard]] Position::StateInfo Position::calculate_state(const Bitboard checkers) const noexcept {
+    constexpr auto them = !S;
+    const auto ksq = king_position(S);
+    const auto occ = occupied();
+    StateInfo info;
+
+    info.checkers = checkers;
+    info.king_allowed = king_allowed<S>();
+
+    // Pins -- enemy sliders that would attack the king if our blockers were removed
+    const auto bq = pieces(them, Piece::Bishop) | pieces(them, Piece::Queen);
+    const auto rq = pieces(them, Piece::Rook) | pieces(them, Piece::Queen);
+    const auto bishop_rays = movegen::bishop_moves(ksq, occ);
+    const auto rook_rays = movegen::rook_moves(ksq, occ);
+    const auto bishop_candidates = bishop_rays & occupancy(S);
+    const auto rook_candidates = rook_rays & occupancy(S);
+
+    for (const auto &sq : movegen::bishop_moves(ksq, occ ^ bishop_candidates) & ~bishop_rays & bq) {
+        info.pinned_diagonal |= squares_between(ksq, sq) & bishop_candidates;
+    }
+    for (const auto &sq : movegen::rook_moves(ksq, occ ^ rook_candidates) & ~rook_rays & rq) {
+        info.pinned_orthogonal |= squares_between(ksq, sq) & rook_candidates;
+    }
+
+    info.diagonal_pin_rays = movegen::bishop_moves(ksq, occ ^ info.pinned_diagonal);
+    info.orthogonal_pin_rays = movegen::rook_moves(ksq, occ ^ info.pinned_orthogonal);
+
+    // Check mask
+    if (info.checkers.empty()) {
+        info.check_mask = ~Bitboard{};
+    } else if (info.checkers.count() == 1) {
+        info.check_mask = info.checkers | squares_between(ksq, info.checkers.lsb());
+    }
+
+    assert((info.pinned_diagonal & info.pinned_orthogonal).empty());
+
+    return info;
+}
+
+}  // namespace libchess
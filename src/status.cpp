@@ -0,0 +1,33 @@
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+[[nodiscard]] Position::Status Position::status() const noexcept {
+    if (!has_legal_move()) {
+        return in_check() ? Status::Checkmate : Status::Stalemate;
+    } else if (fiftymoves()) {
+        return Status::FiftyMoves;
+    } else if (threefold()) {
+        return Status::Threefold;
+    } else if (insufficient_material()) {
+        return Status::InsufficientMaterial;
+    }
+    return Status::Ongoing;
+}
+
+[[nodiscard]] bool Position::insufficient_material() const noexcept {
+    if (occupancy(Piece::Pawn) || occupancy(Piece::Rook) || occupancy(Piece::Queen)) {
+        return false;
+    }
+
+    const auto minors = occupancy(Piece::Knight) | occupancy(Piece::Bishop);
+    if (minors.count() <= 1) {
+        return true;
+    }
+
+    const auto bishops = occupancy(Piece::Bishop);
+    return !occupancy(Piece::Knight) &&
+           (!(bishops & bitboards::LightSquares) || !(bishops & bitboards::DarkSquares));
+}
+
+}  // namespace libchess
@@ -0,0 +1,69 @@
+#include "libchess/tt.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace libchess {
+
+namespace {
+
+// Large tables are aligned to 2MB so the kernel can back them with transparent huge pages
+constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+}  // namespace
+
+TT::~TT() {
+    std::free(buckets_);
+}
+
+void TT::resize(std::size_t mb) {
+    if (mb < 1) {
+        mb = 1;
+    }
+
+    std::free(buckets_);
+    buckets_ = nullptr;
+
+    num_buckets_ = std::bit_floor(mb * 1024 * 1024 / sizeof(Bucket));
+    const auto bytes = num_buckets_ * sizeof(Bucket);
+    const auto alignment = bytes >= huge_page_size ? huge_page_size : alignof(Bucket);
+    allocated_ = (bytes + alignment - 1) / alignment * alignment;
+
+    buckets_ = static_cast<Bucket *>(std::aligned_alloc(alignment, allocated_));
+    if (!buckets_) {
+        num_buckets_ = 0;
+        allocated_ = 0;
+        throw std::bad_alloc();
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (alignment == huge_page_size) {
+        madvise(buckets_, allocated_, MADV_HUGEPAGE);
+    }
+#endif
+
+    clear();
+}
+
+void TT::clear() noexcept {
+    std::memset(static_cast<void *>(buckets_), 0, allocated_);
+}
+
+[[nodiscard]] int TT::hashfull() const noexcept {
+    const auto sample = std::min<std::size_t>(num_buckets_, 250);
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+        for (auto &entry : buckets_[i].entries) {
+            used += load(entry.key) != 0 || load(entry.data) != 0;
+        }
+    }
+    return static_cast<int>(1000 * used / (sample * bucket_size));
+}
+
+}  // namespace libchess
@@ -2,13 +2,24 @@
 
 namespace libchess {
 
+void Position::undomove() noexcept {
+    invalidate_state();
+    // The side that made the move
+    if (turn() == Side::White) {
+        undomove<Side::Black>();
+    } else {
+        undomove<Side::White>();
+    }
+}
+
+template <Side Us>
 void Position::undomove() noexcept {
     // Swap sides
     to_move_ = !to_move_;
+    assert(turn() == Us);
 
     const auto &move = history_.back().move;
-    const auto us = turn();
-    const auto them = !turn();
+    constexpr auto them = !Us;
     const auto piece = move.piece();
     const auto captured = move.captured();
     const auto promo = move.promotion();
@@ -20,26 +31,26 @@ void Position::undomove() noexcept {
     halfmove_clock_ = history_.back().halfmove_clock;
 
     // Fullmoves
-    fullmove_clock_ -= us == Side::Black;
+    fullmove_clock_ -= Us == Side::Black;
 
     // Castling
-    castling_[0] = history_.back().castling[0];
-    castling_[1] = history_.back().castling[1];
-    castling_[2] = history_.back().castling[2];
-    castling_[3] = history_.back().castling[3];
+    castling_ = history_.back().castling;
 
 #ifndef NO_HASH
     hash_ = history_.back().hash;
 #endif
 
     // Remove piece
-    colours_[us] ^= move.to();
+    colours_[Us] ^= move.to();
     pieces_[piece] ^= move.to();
 
     // Add piece
-    colours_[us] ^= move.from();
+    colours_[Us] ^= move.from();
     pieces_[piece] ^= move.from();
 
+    // Put back whatever was captured on the destination square, en passant and castling fix this up below
+    set_mailbox(move.to(), captured);
+
     switch (move.type()) {
         case MoveType::Normal:
             break;
@@ -50,42 +61,53 @@ void Position::undomove() noexcept {
             pieces_[captured] ^= move.to();
             break;
         case MoveType::enpassant:
+            set_mailbox(move.to(), Piece::None);
             // Replace the captured pawn
-            if (turn() == Side::White) {
+            if constexpr (Us == Side::White) {
                 pieces_[Piece::Pawn] ^= move.to().south();
                 colours_[Side::Black] ^= move.to().south();
+                set_mailbox(move.to().south(), Piece::Pawn);
             } else {
                 pieces_[Piece::Pawn] ^= move.to().north();
                 colours_[Side::White] ^= move.to().north();
+                set_mailbox(move.to().north(), Piece::Pawn);
             }
             break;
         case MoveType::ksc:
             // Remove the king that was added instead of removed
-            colours_[us] ^= move.to();
+            colours_[Us] ^= move.to();
             pieces_[piece] ^= move.to();
             // Remove the king from its castled to square
-            colours_[us] ^= castle_king_to[us * 2];
-            pieces_[piece] ^= castle_king_to[us * 2];
+            colours_[Us] ^= castle_king_to[Us * 2];
+            pieces_[piece] ^= castle_king_to[Us * 2];
             // Add the rook
-            colours_[us] ^= move.to();
+            colours_[Us] ^= move.to();
             pieces_[Piece::Rook] ^= move.to();
             // Remove the rook from its after castling square
-            colours_[us] ^= ksc_rook_to[us];
-            pieces_[Piece::Rook] ^= ksc_rook_to[us];
+            colours_[Us] ^= ksc_rook_to[Us];
+            pieces_[Piece::Rook] ^= ksc_rook_to[Us];
+            // Mailbox
+            set_mailbox(castle_king_to[Us * 2], Piece::None);
+            set_mailbox(ksc_rook_to[Us], Piece::None);
+            set_mailbox(move.to(), Piece::Rook);
             break;
         case MoveType::qsc:
             // Remove the king that was added instead of removed
-            colours_[us] ^= move.to();
+            colours_[Us] ^= move.to();
             pieces_[piece] ^= move.to();
             // Remove the king from its castled to square
-            colours_[us] ^= castle_king_to[us * 2 + 1];
-            pieces_[piece] ^= castle_king_to[us * 2 + 1];
+            colours_[Us] ^= castle_king_to[Us * 2 + 1];
+            pieces_[piece] ^= castle_king_to[Us * 2 + 1];
             // Remove the rook
-            colours_[us] ^= castle_rooks_from_[us * 2 + 1];
-            pieces_[Piece::Rook] ^= castle_rooks_from_[us * 2 + 1];
+            colours_[Us] ^= castle_rooks_from_[Us * 2 + 1];
+            pieces_[Piece::Rook] ^= castle_rooks_from_[Us * 2 + 1];
             // Add the rook
-            colours_[us] ^= qsc_rook_to[us];
-            pieces_[Piece::Rook] ^= qsc_rook_to[us];
+            colours_[Us] ^= qsc_rook_to[Us];
+            pieces_[Piece::Rook] ^= qsc_rook_to[Us];
+            // Mailbox
+            set_mailbox(castle_king_to[Us * 2 + 1], Piece::None);
+            set_mailbox(qsc_rook_to[Us], Piece::None);
+            set_mailbox(move.to(), Piece::Rook);
             break;
         case MoveType::promo:
             // Replace piece with pawn
@@ -104,6 +126,14 @@ void Position::undomove() noexcept {
             break;
     }
 
+    // The moved piece goes back last since castling can end on its own start square
+    set_mailbox(move.from(), piece);
+
+    // Pawn and material keys, the board is back to how it was before the move
+    update_keys<Us>(move);
+    non_pawn_material_[them] += captured == Piece::Pawn ? 0 : piece_values[captured];
+    non_pawn_material_[Us] -= piece_values[promo];
+
     // Remove from history
     history_.pop_back();
 
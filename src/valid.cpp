@@ -8,11 +8,16 @@ namespace libchess {
         return false;
     }
 #else
-    if (hash_ != calculate_hash()) {
+    if (hash_ != calculate_hash() || pawn_hash_ != calculate_pawn_hash() || material_hash_ != calculate_material_hash()) {
         return false;
     }
 #endif
 
+    if (non_pawn_material_[Side::White] != calculate_non_pawn_material(Side::White) ||
+        non_pawn_material_[Side::Black] != calculate_non_pawn_material(Side::Black)) {
+        return false;
+    }
+
     if (ep() != squares::OffSq) {
         if (turn() == Side::White && ep().rank() != 5) {
             return false;
@@ -50,6 +55,14 @@ namespace libchess {
         return false;
     }
 
+    for (int i = 0; i < 64; ++i) {
+        const auto sq = Square{i};
+        const auto p = piece_on(sq);
+        if (p == Piece::None ? bool(occupied() & Bitboard{sq}) : !(occupancy(p) & Bitboard{sq})) {
+            return false;
+        }
+    }
+
     // Better not be able to capture the king
     if (square_attacked(king_position(!turn()), turn())) {
         return false;
@@ -0,0 +1,28 @@
+#include "libchess/position.hpp"
+
+namespace libchess {
+
+char *Position::write_uci(char *out, const Move &move, const bool dfrc) const noexcept {
+    auto from = move.from();
+    auto to = move.to();
+
+    // Castling is stored as king takes rook, standard chess writes the king's two square step instead
+    if (!dfrc && (move.type() == MoveType::ksc || move.type() == MoveType::qsc)) {
+        from = turn() == Side::White ? squares::E1 : squares::E8;
+        to = Square{move.type() == MoveType::ksc ? 6 : 2, from.rank()};
+    }
+
+    *out++ = static_cast<char>('a' + from.file());
+    *out++ = static_cast<char>('1' + from.rank());
+    *out++ = static_cast<char>('a' + to.file());
+    *out++ = static_cast<char>('1' + to.rank());
+
+    if (move.promotion() != Piece::None) {
+        constexpr char promo_chars[] = {'n', 'b', 'r', 'q'};
+        *out++ = promo_chars[move.promotion() - 1];
+    }
+
+    return out;
+}
+
+}  // namespace libchess
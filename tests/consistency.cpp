@@ -78,3 +78,34 @@ TEST_CASE("Consistency") {
         valid(pos, 3);
     }
 }
+
+TEST_CASE("Undo history") {
+    auto pos = libchess::Position{"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 300 200"};
+    REQUIRE(pos.history().capacity() == 0);
+
+    for (const auto &movestr : {"e1g1", "a8b8", "g1g2", "b8a8"}) {
+        pos.makemove(movestr);
+        REQUIRE(pos.history().capacity() >= LIBCHESS_MAX_PLY);
+    }
+    pos.makenull();
+    REQUIRE(pos.history().size() == 5);
+
+    // Copies keep the capacity, so they don't reallocate on their next move
+    auto copy = pos;
+    REQUIRE(copy.history().size() == 5);
+    REQUIRE(copy.history().capacity() >= LIBCHESS_MAX_PLY);
+    auto assigned = libchess::Position{"startpos"};
+    assigned = pos;
+    REQUIRE(assigned.history().size() == 5);
+    REQUIRE(assigned.history().capacity() >= LIBCHESS_MAX_PLY);
+    const auto data = copy.history().data();
+    copy.makemove("a8a7");
+    REQUIRE(copy.history().data() == data);
+
+    pos.undonull();
+    for (int i = 0; i < 4; ++i) {
+        pos.undomove();
+    }
+    REQUIRE(pos.history().empty());
+    REQUIRE(pos.get_fen() == "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 300 200");
+}
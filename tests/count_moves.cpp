@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <array>
+#include <libchess/position.hpp>
+#include <ranges>
+#include <string>
+#include "catch.hpp"
+
+const std::array<std::string, 14> count_fens = {{
+    "startpos",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k1r1/8/8/8/8/8/8/R3K2R b KQq - 0 1",
+    "2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K b - b3 0 23",
+    "4k3/8/4r3/3pP3/8/8/8/4K3 w - d6 0 2",
+    "8/6bb/8/8/R1pP2k1/4P3/P7/K7 b - c3 0 1",
+    "4k3/8/8/K2pP2r/8/8/8/8 w - d6 0 1",
+    "4k3/b7/8/2Pp4/8/8/8/6K1 w - d6 0 2",
+    "4k3/2b3q1/3P1P2/4K3/3P1P2/2b3q1/8/8 w - - 0 1",
+    "R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1",
+    "4k3/1P6/8/8/8/8/Pp6/4K3 w - - 0 1",
+    "8/8/8/4k3/5Pp1/8/8/3K4 b - f3 0 1",
+    "4k3/8/8/8/8/8/4q3/4K3 w - - 0 1",
+    "rnbqkbnr/pppp1ppp/8/4p3/6P1/5P2/PPPPP2P/RNBQKBNR b KQkq - 0 2",
+}};
+
+TEST_CASE("Position::count_moves()") {
+    for (const auto &fen : count_fens) {
+        INFO(fen);
+        const auto pos = libchess::Position{fen};
+        const auto moves = pos.legal_moves();
+        REQUIRE(pos.count_moves() == moves.size());
+        REQUIRE(pos.count_moves(pos.turn()) == moves.size());
+    }
+}
+
+TEST_CASE("Position::count_moves() per piece") {
+    for (const auto &fen : count_fens) {
+        INFO(fen);
+        const auto pos = libchess::Position{fen};
+        const auto moves = pos.legal_moves();
+
+        for (const auto piece : libchess::pieces) {
+            INFO(piece);
+            const auto expected = std::ranges::count_if(moves, [piece](const auto &move) {
+                return move.piece() == piece;
+            });
+            REQUIRE(pos.count_moves(pos.turn(), piece) == static_cast<std::size_t>(expected));
+        }
+    }
+}
+
+TEST_CASE("Position::count_moves() side not to move") {
+    using pair_type = std::pair<std::string, std::string>;
+
+    const std::array<pair_type, 4> tests = {{
+        {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1"},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+         "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1"},
+        {"2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K b - b3 0 23",
+         "2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K w - - 0 23"},
+        {"4k3/8/8/K2pP2r/8/8/8/8 w - d6 0 1", "4k3/8/8/K2pP2r/8/8/8/8 b - - 0 1"},
+    }};
+
+    for (const auto &[fen, flipped] : tests) {
+        INFO(fen);
+        const auto pos = libchess::Position{fen};
+        const auto other = libchess::Position{flipped};
+        REQUIRE(pos.count_moves(!pos.turn()) == other.count_moves());
+    }
+}
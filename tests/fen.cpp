@@ -161,3 +161,96 @@ TEST_CASE("FEN - DFRC Illegal castling") {
         CHECK(pos.get_fen(true) == corrected);
     }
 }
+
+TEST_CASE("Position::write_fen()") {
+    const std::array<std::pair<std::string, bool>, 4> fens = {{
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", false},
+        {"rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b HAha e3 0 3", true},
+        {"8/8/8/8/8/8/8/k6K w - - 65535 999999999", false},
+        {"qrkbnnbr/pppppppp/8/8/8/8/PPPPPPPP/BBNRKQRN w GDhb - 12 40", true},
+    }};
+
+    for (const auto &[fen, dfrc] : fens) {
+        INFO(fen);
+        const libchess::Position pos{fen, dfrc};
+        std::array<char, libchess::Position::max_fen_size + 1> buffer;
+        buffer.fill('#');
+
+        const auto end = pos.write_fen(buffer.data(), dfrc);
+        REQUIRE(std::string(buffer.data(), end) == fen);
+        REQUIRE(*end == '#');
+    }
+}
+
+TEST_CASE("FEN - try_set_fen() errors") {
+    using Field = libchess::Position::FenError::Field;
+    using tuple_type = std::tuple<std::string, Field, std::size_t>;
+
+    const std::array<tuple_type, 23> tests = {{
+        {"", Field::Board, 0},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", Field::Turn, 43},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNX w KQkq - 0 1", Field::Board, 42},
+        {"rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", Field::Board, 18},
+        {"rnbqkbnr/ppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", Field::Board, 16},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR/8 w KQkq - 0 1", Field::Board, 43},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1", Field::Board, 34},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQ1BNR w kq - 0 1", Field::Board, 0},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKKNR w KQkq - 0 1", Field::Board, 0},
+        {"rnbqkbnP/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", Field::Board, 7},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", Field::Turn, 44},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1", Field::Castling, 48},
+        {"4k3/8/8/8/8/8/4K3/R6R w KQ - 0 1", Field::Castling, 24},
+        {"K6r/8/8/8/8/8/8/k7 b - - 0 1", Field::Turn, 19},
+        {"rnbqkbnr/pppppppp/8/8/8/N7/PPPPPPPP/RNBQKBNR w KQkq - 0 1", Field::Board, 0},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq", Field::EnPassant, 50},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e4 0 1", Field::EnPassant, 51},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3 0 1", Field::EnPassant, 51},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq i6 0 1", Field::EnPassant, 51},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - -1 1", Field::Halfmove, 53},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 70000 1", Field::Halfmove, 53},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 x", Field::Fullmove, 55},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 bm e4;", Field::Trailing, 57},
+    }};
+
+    for (const auto &[fen, field, offset] : tests) {
+        INFO(fen);
+        auto pos = libchess::Position{"startpos"};
+        pos.makemove("e2e4");
+        const auto before = pos.get_fen();
+
+        const auto error = pos.try_set_fen(fen);
+        REQUIRE(error);
+        REQUIRE(error.field == field);
+        REQUIRE(error.offset == offset);
+        REQUIRE(!error.reason.empty());
+
+        // Nothing changes
+        REQUIRE(pos.get_fen() == before);
+        REQUIRE(pos.history().size() == 1);
+
+        REQUIRE_THROWS_AS(libchess::Position{fen}, std::invalid_argument);
+    }
+}
+
+TEST_CASE("FEN - try_set_fen() accepts") {
+    using pair_type = std::pair<std::string, std::string>;
+
+    const std::array<pair_type, 5> tests = {{
+        {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"},
+        {"  rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR   b KQkq - 3 7\r\n",
+         "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 3 7"},
+        // The move counters can be left out
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+         "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 0"},
+        {"rnbqkbnr/pppp1ppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3",
+         "rnbqkbnr/pppp1ppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3"},
+        {"4k3/8/8/8/8/8/8/4K3 w - - 65535 999999999", "4k3/8/8/8/8/8/8/4K3 w - - 65535 999999999"},
+    }};
+
+    for (const auto &[fen, expected] : tests) {
+        INFO(fen);
+        libchess::Position pos;
+        REQUIRE(!pos.try_set_fen(fen));
+        REQUIRE(pos.get_fen() == expected);
+    }
+}
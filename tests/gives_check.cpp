@@ -0,0 +1,84 @@
+#include <array>
+#include <cstdint>
+#include <libchess/position.hpp>
+#include <string>
+#include "catch.hpp"
+
+namespace {
+
+const std::array<std::string, 10> fens = {{
+    "startpos",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    // Discovered check by en passant, promotion through the square just left, castling rook
+    "8/8/8/R2pP2k/8/8/8/K7 w - d6 0 1",
+    "3r4/4P3/5k2/8/8/8/8/4K3 w - - 0 1",
+    "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1",
+    "5k2/8/8/8/8/8/8/4K2R w K - 0 1",
+    "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+}};
+
+[[nodiscard]] bool check_after(libchess::Position pos, const libchess::Move &move) {
+    pos.makemove(move);
+    return pos.in_check();
+}
+
+}  // namespace
+
+TEST_CASE("Position::gives_check()") {
+    for (const auto &fen : fens) {
+        INFO(fen);
+        const libchess::Position pos{fen, true};
+        for (const auto &move : pos.legal_moves()) {
+            INFO(static_cast<std::string>(move));
+            REQUIRE(pos.gives_check(move) == check_after(pos, move));
+        }
+    }
+}
+
+TEST_CASE("Position::gives_check() special moves") {
+    using pair_type = std::pair<std::string, std::string>;
+
+    const std::array<pair_type, 4> tests = {{
+        {"8/8/8/R2pP2k/8/8/8/K7 w - d6 0 1", "e5d6"},
+        {"3r4/4P3/5k2/8/8/8/8/4K3 w - - 0 1", "e7d8q"},
+        {"3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", "e1c1"},
+        {"5k2/8/8/8/8/8/8/4K2R w K - 0 1", "e1g1"},
+    }};
+
+    for (const auto &[fen, movestr] : tests) {
+        INFO(fen);
+        const libchess::Position pos{fen};
+        REQUIRE(pos.gives_check(pos.parse_move(movestr)));
+    }
+}
+
+TEST_CASE("Position::gives_check() keeps checkers() correct through makemove") {
+    std::uint64_t seed = 0x2545f4914f6cdd1dULL;
+    const auto random = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    };
+
+    for (const auto &fen : fens) {
+        for (int game = 0; game < 10; ++game) {
+            libchess::Position pos{fen, true};
+            for (int ply = 0; ply < 100; ++ply) {
+                INFO(pos.get_fen());
+                const auto moves = pos.legal_moves();
+                if (moves.empty()) {
+                    break;
+                }
+                const auto move = moves[random() % moves.size()];
+                const auto check = pos.gives_check(move);
+                pos.makemove(move);
+                REQUIRE(pos.checkers() == pos.attackers(pos.king_position(pos.turn()), !pos.turn()));
+                REQUIRE(pos.in_check() == check);
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#include <array>
+#include <libchess/position.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+#include "catch.hpp"
+
+TEST_CASE("Position::has_game_cycle()") {
+#ifndef NO_HASH
+    // White's knight can go back to g1 and repeat the start position
+    {
+        auto pos = libchess::Position{"startpos"};
+        for (const auto &movestr : {"g1f3", "g8f6", "f3g1"}) {
+            REQUIRE(!pos.has_game_cycle(10));
+            pos.makemove(movestr);
+        }
+        REQUIRE(pos.has_game_cycle(10));
+        // Behind the root the start position would have to have repeated already
+        REQUIRE(!pos.has_game_cycle(0));
+    }
+
+    // A cycle only needs to be reachable, the move back doesn't have to be the last one played
+    {
+        auto pos = libchess::Position{"4k3/8/8/8/8/8/8/R3K3 w - - 0 1"};
+        for (const auto &movestr : {"a1a5", "e8d8", "a5a7", "d8e8"}) {
+            pos.makemove(movestr);
+        }
+        REQUIRE(pos.has_game_cycle(10));
+    }
+
+    // The rook could go back to a5 if the pawn weren't in the way
+    {
+        auto pos = libchess::Position{"4k3/8/p7/8/8/8/8/R3K3 w - - 0 1"};
+        for (const auto &movestr : {"a1a5", "e8f8", "a5b5", "f8g8", "b5b7", "g8f8", "b7a7", "f8e8"}) {
+            pos.makemove(movestr);
+        }
+        REQUIRE(!pos.has_game_cycle(10));
+    }
+
+    // An irreversible move in between
+    {
+        auto pos = libchess::Position{"startpos"};
+        for (const auto &movestr : {"g1f3", "e7e6", "f3g1"}) {
+            pos.makemove(movestr);
+        }
+        REQUIRE(!pos.has_game_cycle(10));
+    }
+
+    // Past the root, once the position has been seen twice
+    {
+        auto pos = libchess::Position{"startpos"};
+        for (const auto &movestr : {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1"}) {
+            pos.makemove(movestr);
+        }
+        REQUIRE(pos.has_game_cycle(0));
+    }
+#endif
+}
+
+TEST_CASE("Position::has_game_cycle() agrees with one move lookahead") {
+#ifndef NO_HASH
+    // Whenever a legal quiet move would repeat a position, a cycle is reported
+    using pair_type = std::pair<std::string, std::vector<std::string>>;
+    const std::array<pair_type, 2> tests = {{
+        {"startpos", {"b1c3", "b8c6", "g1f3", "g8f6", "c3b1", "c6b8", "f3g1"}},
+        {"r2q1rk1/pp1bppbp/2np1np1/8/2BNP3/2N1BP2/PPPQ2PP/R3K2R w KQ - 5 10", {"c3a4", "c6a5", "a4c3", "a5c6"}},
+    }};
+
+    for (const auto &[fen, moves] : tests) {
+        auto pos = libchess::Position{fen};
+        for (const auto &movestr : moves) {
+            pos.makemove(movestr);
+
+            bool repeats = false;
+            for (const auto &move : pos.legal_moves()) {
+                pos.makemove(move);
+                for (std::size_t i = 2; i <= pos.history().size(); ++i) {
+                    repeats |= pos.history()[pos.history().size() - i].hash == pos.hash();
+                }
+                pos.undomove();
+            }
+            INFO(pos.get_fen());
+            REQUIRE(pos.has_game_cycle(100) == repeats);
+        }
+    }
+#endif
+}
@@ -98,3 +98,74 @@ TEST_CASE("Predict hash") {
     }
 #endif
 }
+
+TEST_CASE("Predict hash 960") {
+#ifndef NO_HASH
+    const std::array<std::string, 3> fens = {{
+        "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+        "2r1kr2/8/8/8/8/8/8/1R2K1R1 w GBfc - 0 1",
+        "rk2r3/8/8/8/8/8/8/RK2R3 w EAea - 0 1",
+    }};
+
+    for (const auto &fen : fens) {
+        INFO(fen);
+        auto pos = libchess::Position{fen, true};
+        test(pos, 3);
+    }
+#endif
+}
+
+void test_keys(libchess::Position &pos, const int depth) {
+    REQUIRE(pos.pawn_hash() == pos.calculate_pawn_hash());
+    REQUIRE(pos.material_hash() == pos.calculate_material_hash());
+    REQUIRE(pos.non_pawn_material(libchess::Side::White) == pos.calculate_non_pawn_material(libchess::Side::White));
+    REQUIRE(pos.non_pawn_material(libchess::Side::Black) == pos.calculate_non_pawn_material(libchess::Side::Black));
+
+    if (depth == 0) {
+        return;
+    }
+
+    for (const auto &move : pos.legal_moves()) {
+        const auto pawn_hash = pos.pawn_hash();
+        const auto material_hash = pos.material_hash();
+
+        pos.makemove(move);
+        if (move.piece() != libchess::Piece::Pawn && move.captured() != libchess::Piece::Pawn) {
+            REQUIRE(pos.pawn_hash() == pawn_hash);
+        }
+        if (!move.is_capturing() && move.promotion() == libchess::Piece::None) {
+            REQUIRE(pos.material_hash() == material_hash);
+        }
+        test_keys(pos, depth - 1);
+        pos.undomove();
+
+        REQUIRE(pos.pawn_hash() == pawn_hash);
+        REQUIRE(pos.material_hash() == material_hash);
+    }
+}
+
+TEST_CASE("Pawn and material hash") {
+#ifndef NO_HASH
+    const std::array<std::string, 5> fens = {{
+        "startpos",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "4k3/8/8/2pP4/8/8/8/4K3 w - c6 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+    }};
+
+    for (const auto &fen : fens) {
+        INFO(fen);
+        auto pos = libchess::Position{fen};
+        test_keys(pos, 3);
+    }
+
+    // Same material in different places
+    const auto a = libchess::Position{"4k3/8/8/8/8/8/4P3/R3K3 w - - 0 1"};
+    const auto b = libchess::Position{"4k3/8/8/3R4/8/8/P7/4K3 b - - 0 1"};
+    REQUIRE(a.material_hash() == b.material_hash());
+    REQUIRE(a.pawn_hash() != b.pawn_hash());
+    REQUIRE(a.non_pawn_material(libchess::Side::White) == 500);
+    REQUIRE(a.non_pawn_material(libchess::Side::Black) == 0);
+#endif
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 #include <libchess/position.hpp>
 #include <string>
@@ -23,3 +24,51 @@ TEST_CASE("Position::is_legal()") {
         }
     }
 }
+
+TEST_CASE("Position::is_legal() -- Moves from other positions") {
+    const std::array<std::string, 10> fens = {{
+        "startpos",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "4k3/8/4r3/3pP3/8/8/8/4K3 w - d6 0 2",
+        "8/6bb/8/8/R1pP2k1/4P3/P7/K7 b - c3 0 1",
+        "4k3/8/8/8/8/8/2q5/R3K2R w KQ - 0 1",
+        "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+    }};
+
+    // Every move legal somewhere else should only be accepted where it's actually legal
+    for (const auto &fen : fens) {
+        INFO(fen);
+        const libchess::Position pos{fen};
+        const auto legal = pos.legal_moves();
+        for (const auto &other : fens) {
+            const libchess::Position pos2{other};
+            for (const auto &move : pos2.legal_moves()) {
+                INFO(static_cast<std::string>(move));
+                REQUIRE(pos.is_legal(move) == (std::find(legal.begin(), legal.end(), move) != legal.end()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Position::is_legal() -- Malformed moves") {
+    using namespace libchess;
+    const Position pos{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+
+    // Wrong piece, wrong capture, wrong type, blocked slider
+    REQUIRE(!pos.is_legal(Move{}));
+    REQUIRE(!pos.is_legal(Move(MoveType::Normal, squares::E5, squares::D7, Piece::Bishop)));
+    REQUIRE(!pos.is_legal(Move(MoveType::Capture, squares::E5, squares::D7, Piece::Knight, Piece::Queen)));
+    REQUIRE(!pos.is_legal(Move(MoveType::Normal, squares::E5, squares::D7, Piece::Knight)));
+    REQUIRE(!pos.is_legal(Move(MoveType::Double, squares::A2, squares::A3, Piece::Pawn)));
+    REQUIRE(!pos.is_legal(Move(MoveType::Normal, squares::A2, squares::A4, Piece::Pawn)));
+    REQUIRE(!pos.is_legal(Move(MoveType::Normal, squares::A1, squares::A3, Piece::Rook)));
+    REQUIRE(!pos.is_legal(Move(MoveType::enpassant, squares::D5, squares::E6, Piece::Pawn, Piece::Pawn)));
+    REQUIRE(pos.is_legal(Move(MoveType::Capture, squares::E5, squares::D7, Piece::Knight, Piece::Pawn)));
+    REQUIRE(pos.is_legal(Move(MoveType::Double, squares::A2, squares::A4, Piece::Pawn)));
+    REQUIRE(pos.is_legal(Move(MoveType::ksc, squares::E1, squares::H1, Piece::King)));
+    REQUIRE(pos.is_legal(Move(MoveType::qsc, squares::E1, squares::A1, Piece::King)));
+}
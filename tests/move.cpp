@@ -1,6 +1,7 @@
 #include <array>
 #include <libchess/position.hpp>
 #include <string>
+#include <tuple>
 #include "catch.hpp"
 
 TEST_CASE("Move strings") {
@@ -95,3 +96,32 @@ TEST_CASE("Move strings DFRC") {
         REQUIRE(found);
     }
 }
+
+TEST_CASE("Position::write_uci()") {
+    using tuple_type = std::tuple<std::string, bool, std::string>;
+
+    const std::array<tuple_type, 6> tests = {{
+        {"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", false, "e1g1"},
+        {"r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1", false, "e8c8"},
+        {"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", true, "e1h1"},
+        {"1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1", false, "a7b8n"},
+        {"1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1", false, "a7a8q"},
+        {"4k3/8/8/8/8/8/8/4K3 w - - 0 1", false, "e1d1"},
+    }};
+
+    for (const auto &[fen, dfrc, movestr] : tests) {
+        INFO(fen);
+        INFO(movestr);
+        const auto pos = libchess::Position{fen, dfrc};
+
+        auto found = false;
+        for (const auto &move : pos.legal_moves()) {
+            char buffer[5];
+            const auto str = std::string(buffer, pos.write_uci(buffer, move, dfrc));
+            REQUIRE(str == pos.move_string(move, dfrc));
+            found |= str == movestr;
+        }
+
+        REQUIRE(found);
+    }
+}
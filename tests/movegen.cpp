@@ -81,3 +81,41 @@ TEST_CASE("Movegen king") {
         REQUIRE(libchess::movegen::king_moves(sq) == libchess::Bitboard(moves));
     }
 }
+
+TEST_CASE("Movegen sliders -- Random blockers") {
+    // Walk each ray one square at a time as a reference for the lookup tables
+    const auto ray = [](const libchess::Square sq, const libchess::Bitboard blockers, const int dx, const int dy) {
+        libchess::Bitboard result;
+        for (int x = sq.file() + dx, y = sq.rank() + dy; x >= 0 && x <= 7 && y >= 0 && y <= 7; x += dx, y += dy) {
+            const auto bb = libchess::Bitboard{libchess::Square{x + 8 * y}};
+            result |= bb;
+            if (blockers & bb) {
+                break;
+            }
+        }
+        return result;
+    };
+
+    std::uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    const auto rand = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    };
+
+    INFO(libchess::movegen::slider_backend());
+
+    for (int i = 0; i < 64; ++i) {
+        const auto sq = libchess::Square{i};
+        for (int j = 0; j < 200; ++j) {
+            const auto blockers = libchess::Bitboard{rand() & rand()};
+            const auto bishop = ray(sq, blockers, 1, 1) | ray(sq, blockers, 1, -1) | ray(sq, blockers, -1, 1) |
+                                ray(sq, blockers, -1, -1);
+            const auto rook =
+                ray(sq, blockers, 1, 0) | ray(sq, blockers, -1, 0) | ray(sq, blockers, 0, 1) | ray(sq, blockers, 0, -1);
+            REQUIRE(libchess::movegen::bishop_moves(sq, blockers) == bishop);
+            REQUIRE(libchess::movegen::rook_moves(sq, blockers) == rook);
+        }
+    }
+}
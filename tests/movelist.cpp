@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <array>
+#include <libchess/movelist.hpp>
+#include <libchess/position.hpp>
+#include <ranges>
+#include <string>
+#include "catch.hpp"
+
+TEST_CASE("MoveList basics") {
+    libchess::MoveList moves;
+    REQUIRE(moves.empty());
+    REQUIRE(moves.size() == 0);
+
+    const auto move = libchess::Move(libchess::MoveType::Normal,
+                                     libchess::squares::A2,
+                                     libchess::squares::A3,
+                                     libchess::Piece::Pawn);
+    moves.push_back(move);
+    moves.emplace_back(libchess::MoveType::Double, libchess::squares::A2, libchess::squares::A4, libchess::Piece::Pawn);
+
+    REQUIRE(moves.size() == 2);
+    REQUIRE(moves[0] == move);
+    REQUIRE(moves.back().type() == libchess::MoveType::Double);
+    REQUIRE(moves.contains(move));
+
+    moves.pop_back();
+    REQUIRE(moves.size() == 1);
+    moves.clear();
+    REQUIRE(moves.empty());
+    REQUIRE(!moves.contains(move));
+}
+
+TEST_CASE("MoveList matches std::vector generators") {
+    const std::array<std::string, 7> fens = {{
+        "startpos",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k1r1/8/8/8/8/8/8/R3K2R b KQq - 0 1",
+        "2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K b - b3 0 23",
+        "4k3/8/4r3/3pP3/8/8/8/4K3 w - d6 0 2",
+        "R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1",
+        "4k3/8/8/8/8/8/8/r3K2R w K - 0 1",
+    }};
+
+    for (const auto &fen : fens) {
+        INFO(fen);
+        const auto pos = libchess::Position{fen};
+
+        libchess::MoveList moves;
+        libchess::MoveList captures;
+        libchess::MoveList noncaptures;
+        libchess::MoveList evasions;
+        pos.legal_moves(moves);
+        pos.legal_captures(captures);
+        pos.legal_noncaptures(noncaptures);
+        pos.check_evasions(evasions);
+
+        REQUIRE(std::ranges::equal(moves, pos.legal_moves()));
+        REQUIRE(std::ranges::equal(captures, pos.legal_captures()));
+        REQUIRE(std::ranges::equal(noncaptures, pos.legal_noncaptures()));
+        REQUIRE(std::ranges::equal(evasions, pos.check_evasions()));
+    }
+}
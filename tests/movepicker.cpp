@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <array>
+#include <libchess/movepicker.hpp>
+#include <libchess/position.hpp>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+
+namespace {
+
+[[nodiscard]] std::vector<libchess::Move> pick_all(libchess::MovePicker &picker) {
+    std::vector<libchess::Move> moves;
+    libchess::Move move;
+    while (picker.next(move)) {
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+[[nodiscard]] bool same_moves(std::vector<libchess::Move> a, std::vector<libchess::Move> b) {
+    const auto cmp = [](const libchess::Move &lhs, const libchess::Move &rhs) {
+        return static_cast<std::string>(lhs) < static_cast<std::string>(rhs) ||
+               (static_cast<std::string>(lhs) == static_cast<std::string>(rhs) && lhs.type() < rhs.type());
+    };
+    std::sort(a.begin(), a.end(), cmp);
+    std::sort(b.begin(), b.end(), cmp);
+    return a == b;
+}
+
+const std::array<std::string, 6> fens = {{
+    "startpos",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "4k3/8/8/8/8/8/8/r3K3 w - - 0 1",
+}};
+
+}  // namespace
+
+TEST_CASE("MovePicker -- Same moves as legal_moves") {
+    for (const auto &fen : fens) {
+        INFO(fen);
+        const libchess::Position pos{fen};
+        const auto legal = pos.legal_moves();
+
+        // No hints
+        {
+            libchess::MovePicker picker{pos};
+            REQUIRE(same_moves(pick_all(picker), legal));
+        }
+
+        // Every legal move as the hash move and killer
+        for (const auto &hint : legal) {
+            INFO(static_cast<std::string>(hint));
+            libchess::MovePicker picker{pos, hint, hint, legal.back(), legal.front()};
+            const auto picked = pick_all(picker);
+            REQUIRE(picked.front() == hint);
+            REQUIRE(same_moves(picked, legal));
+        }
+    }
+}
+
+TEST_CASE("MovePicker -- Illegal hints are ignored") {
+    const libchess::Position pos{"startpos"};
+    const auto bad1 = libchess::Move(libchess::MoveType::Normal,
+                                     libchess::squares::E2,
+                                     libchess::squares::E5,
+                                     libchess::Piece::Pawn);
+    const auto bad2 = libchess::Move(libchess::MoveType::Capture,
+                                     libchess::squares::D1,
+                                     libchess::squares::D7,
+                                     libchess::Piece::Queen,
+                                     libchess::Piece::Pawn);
+    libchess::MovePicker picker{pos, bad1, bad2, bad1, bad2};
+    REQUIRE(same_moves(pick_all(picker), pos.legal_moves()));
+}
+
+TEST_CASE("MovePicker -- Stage order") {
+    const libchess::Position pos{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+    const auto killer = libchess::Move(libchess::MoveType::Normal,
+                                       libchess::squares::A2,
+                                       libchess::squares::A3,
+                                       libchess::Piece::Pawn);
+    libchess::MovePicker picker{pos, {}, killer};
+    const auto picked = pick_all(picker);
+    const auto num_captures = pos.legal_captures().size();
+
+    REQUIRE(picked.size() == pos.legal_moves().size());
+    for (std::size_t i = 0; i < picked.size(); ++i) {
+        REQUIRE(picked[i].is_capturing() == (i < num_captures));
+    }
+    // Most valuable victim first
+    constexpr int values[] = {1, 3, 3, 5, 9};
+    for (std::size_t i = 1; i < num_captures; ++i) {
+        REQUIRE(values[picked[i - 1].captured()] >= values[picked[i].captured()]);
+    }
+    REQUIRE(picked[num_captures] == killer);
+}
+
+TEST_CASE("MovePicker -- Skip quiets") {
+    for (const auto &fen : fens) {
+        INFO(fen);
+        const libchess::Position pos{fen};
+        libchess::MovePicker picker{pos};
+        picker.skip_quiets();
+        REQUIRE(same_moves(pick_all(picker), pos.legal_captures()));
+        REQUIRE(picker.stage() == libchess::MovePicker::Stage::Done);
+    }
+}
@@ -0,0 +1,118 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <libchess/position.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "catch.hpp"
+
+namespace {
+
+void check_round_trip(const libchess::Position &pos, const bool dfrc) {
+    libchess::PackedPosition packed;
+    REQUIRE(pos.pack(packed));
+
+    // Through raw bytes, as if read back from a file
+    std::array<char, sizeof(libchess::PackedPosition)> bytes;
+    std::memcpy(bytes.data(), &packed, bytes.size());
+    libchess::PackedPosition copy;
+    std::memcpy(&copy, bytes.data(), bytes.size());
+
+    const auto unpacked = libchess::Position{copy};
+    REQUIRE(unpacked.get_fen(dfrc) == pos.get_fen(dfrc));
+    REQUIRE(unpacked.hash() == pos.hash());
+    REQUIRE(unpacked.legal_moves().size() == pos.legal_moves().size());
+}
+
+}  // namespace
+
+TEST_CASE("PackedPosition - Round trip") {
+    const std::array<std::pair<std::string, bool>, 10> fens = {{
+        {"startpos", false},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", false},
+        {"rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3", false},
+        {"rnbqkb1r/pp1p1ppp/5n2/2pPp3/8/8/PPP1PPPP/RNBQKBNR w KQkq e6 0 4", false},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 50 99", false},
+        {"4k3/8/8/8/8/8/8/4K3 b - - 65000 16000000", false},
+        {"qnnrkrbb/pppppppp/8/8/8/8/PPPPPPPP/BBQNNRKR w HFfd - 0 1", true},
+        {"rbknbrnq/pppppppp/8/8/8/8/PPPPPPPP/BQNBRNKR w HEfa - 0 1", true},
+        {"bbqnnrkr/pppppppp/8/8/8/8/PPPPPPPP/RQKRBBNN w DAhf - 0 1", true},
+        {"1r1kr3/8/8/8/8/8/8/1R1KR3 b BEbe - 7 20", true},
+    }};
+
+    for (const auto &[fen, dfrc] : fens) {
+        INFO(fen);
+        auto pos = libchess::Position{fen, dfrc};
+        check_round_trip(pos, dfrc);
+
+        // Follow a fixed line of play so castling rights, en passant squares and the counters change
+        std::uint64_t seed = 0x2545F4914F6CDD1DULL;
+        for (int ply = 0; ply < 60; ++ply) {
+            const auto moves = pos.legal_moves();
+            if (moves.empty()) {
+                break;
+            }
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            pos.makemove(moves[(seed >> 33) % moves.size()]);
+            check_round_trip(pos, dfrc);
+        }
+    }
+}
+
+TEST_CASE("PackedPosition - Counters are capped") {
+    const auto pos = libchess::Position{"4k3/8/8/8/8/8/8/4K3 w - - 0 999999999"};
+    libchess::PackedPosition packed;
+    REQUIRE(pos.pack(packed));
+    const auto unpacked = libchess::Position{packed};
+    REQUIRE(unpacked.fullmoves() == 16777215);
+}
+
+TEST_CASE("PackedPosition - Corrupted bytes") {
+    libchess::PackedPosition startpos;
+    REQUIRE(libchess::Position{"startpos"}.pack(startpos));
+
+    // White to move and in check, flipping the turn leaves the side not to move in check
+    libchess::PackedPosition in_check;
+    REQUIRE(libchess::Position{"4k3/8/8/8/8/8/8/r3K3 w - - 0 1"}.pack(in_check));
+
+    auto piece_code = startpos;
+    piece_code.pieces[0] = static_cast<std::uint8_t>((piece_code.pieces[0] & 0xF0) | 0x6);
+    auto too_many = startpos;
+    too_many.occupied = ~0ULL;
+    auto ep_range = startpos;
+    ep_range.state = (ep_range.state & ~0xFEU) | 100U << 1;
+    auto ep_rank = startpos;
+    ep_rank.state = (ep_rank.state & ~0xFEU) | 20U << 1;
+    auto two_kings = startpos;
+    two_kings.pieces[1] = static_cast<std::uint8_t>((two_kings.pieces[1] & 0x0F) | 0x5 << 4);
+    auto no_king = startpos;
+    no_king.pieces[14] = static_cast<std::uint8_t>((no_king.pieces[14] & 0xF0) | 0xC);
+    auto castling = startpos;
+    castling.castling = static_cast<std::uint16_t>((castling.castling & ~0x70U) | 6U << 4);
+    auto turn = in_check;
+    turn.state ^= 1;
+
+    const std::array<libchess::PackedPosition, 8> tests = {{
+        piece_code,
+        too_many,
+        ep_range,
+        ep_rank,
+        two_kings,
+        no_king,
+        castling,
+        turn,
+    }};
+
+    for (std::size_t i = 0; i < tests.size(); ++i) {
+        INFO(i);
+        auto pos = libchess::Position{"startpos"};
+        REQUIRE_FALSE(pos.unpack(tests[i]));
+        REQUIRE(pos.get_fen() == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        REQUIRE_THROWS_AS(libchess::Position{tests[i]}, std::invalid_argument);
+    }
+
+    auto pos = libchess::Position{};
+    REQUIRE(pos.unpack(in_check));
+    REQUIRE(pos.get_fen() == "4k3/8/8/8/8/8/8/r3K3 w - - 0 1");
+}
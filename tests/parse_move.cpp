@@ -1,6 +1,8 @@
 #include <array>
 #include <libchess/position.hpp>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include "catch.hpp"
 
 TEST_CASE("Position::parse_move()") {
@@ -61,3 +63,69 @@ TEST_CASE("Position::parse_move() exceptions") {
         REQUIRE_THROWS(pos.parse_move(movestring));
     }
 }
+
+TEST_CASE("Position::try_parse_move() matches the legal moves") {
+    using pair_type = std::pair<std::string, bool>;
+
+    const std::array<pair_type, 8> fens = {{
+        {"startpos", false},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", false},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", false},
+        {"rnbqkb1r/pp1p1ppp/5n2/2pPp3/8/8/PPP1PPPP/RNBQKBNR w KQkq e6 0 4", false},
+        {"8/8/8/4k3/5Pp1/8/8/3K4 b - f3 0 1", false},
+        {"1r2k2r/8/8/8/8/8/8/R3KR2 w FAhb - 0 1", true},
+        {"qnnrkrbb/pppppppp/8/8/8/8/PPPPPPPP/BBQNNRKR w HFfd - 0 1", true},
+        {"1rk2r2/8/8/8/8/8/8/1RK2R2 w FBfb - 0 1", true},
+    }};
+    const std::array<std::string, 5> promos = {{"", "n", "b", "r", "q"}};
+
+    for (const auto &[fen, dfrc] : fens) {
+        INFO(fen);
+        const auto pos = libchess::Position{fen, dfrc};
+        const auto moves = pos.legal_moves();
+
+        // Every string is either a legal move as written by move_string() or rejected
+        for (int from = 0; from < 64; ++from) {
+            for (int to = 0; to < 64; ++to) {
+                for (const auto &promo : promos) {
+                    const auto str = libchess::square_strings[from] + libchess::square_strings[to] + promo;
+                    INFO(str);
+                    const auto move = pos.try_parse_move(str);
+
+                    auto expected = libchess::Move{};
+                    for (const auto &m : moves) {
+                        // Standard castling notation only applies with the king on its usual square
+                        const auto standard = pos.move_string(m, false) == str && m.from() == libchess::Square(from);
+                        if (standard || pos.move_string(m, true) == str) {
+                            expected = m;
+                        }
+                    }
+
+                    REQUIRE(move == expected);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Position::try_parse_move() rejects") {
+    const std::array<std::string, 10> strings = {{
+        "",
+        "e2",
+        "e2e4qq",
+        "e2e4q",
+        "E2E4",
+        "e2e9",
+        "i2i4",
+        "e7e8k",
+        "e1e1",
+        "e1g1",
+    }};
+
+    const auto pos = libchess::Position{"4k3/4P3/8/8/8/8/4P3/4K2R w - - 0 1"};
+    for (const auto &str : strings) {
+        INFO(str);
+        REQUIRE(!pos.try_parse_move(str));
+        REQUIRE_THROWS_AS(pos.parse_move(str), std::invalid_argument);
+    }
+}
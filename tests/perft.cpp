@@ -1,5 +1,6 @@
 #include <array>
 #include <cstdint>
+#include <libchess/perft.hpp>
 #include <libchess/position.hpp>
 #include <string>
 #include <vector>
@@ -131,6 +132,21 @@ TEST_CASE("En passant -- Horizontally block check") {
     }
 }
 
+TEST_CASE("En passant -- Doesn't resolve check") {
+    const std::array<pair_type, 2> positions = {{
+        {"nrk1brnb/pp1ppp1p/2p5/3q1Pp1/8/PP6/1KPPP1PP/NR1QBRNB w - g6 0 10", {1, 5}},
+        {"8/8/8/6k1/3Pp3/8/8/2B1K3 b - d3 0 1", {1, 7}},
+    }};
+
+    for (const auto &[fen, nodes] : positions) {
+        INFO(fen);
+        libchess::Position pos{fen};
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            REQUIRE(pos.perft(i) == nodes[i]);
+        }
+    }
+}
+
 TEST_CASE("Perft - Many moves") {
     INFO("Perft position with the most known moves");
     const auto pos = libchess::Position("R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1");
@@ -202,3 +218,24 @@ TEST_CASE("Perft DFRC - Shallow") {
         }
     }
 }
+
+TEST_CASE("perft_parallel()") {
+    const std::array<pair_type, 4> tests = {{
+        {"startpos", {20, 400, 8902, 197281}},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039, 97862}},
+        {"8/8/8/8/1k1PpN1R/8/8/4K3 b - d3 0 1", {9, 193, 1322}},
+        {"4k3/8/8/8/8/8/8/4K3 w - - 0 1", {5, 25, 170, 1156}},
+    }};
+
+    for (const auto &[fen, nodes] : tests) {
+        INFO(fen);
+        const auto pos = libchess::Position(fen);
+        for (const int threads : {1, 2, 3, 4}) {
+            INFO(threads);
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                REQUIRE(libchess::perft_parallel(pos, i + 1, threads) == nodes.at(i));
+            }
+        }
+        REQUIRE(pos.get_fen() == libchess::Position(fen).get_fen());
+    }
+}
@@ -0,0 +1,79 @@
+#include <array>
+#include <libchess/position.hpp>
+#include <string>
+#include "catch.hpp"
+
+TEST_CASE("Position::piece_on() & Position::owner_on()") {
+    using tuple_type = std::tuple<std::string, libchess::Square, libchess::Piece, libchess::Side>;
+
+    const std::array<tuple_type, 6> tests = {{
+        {"startpos", libchess::squares::E1, libchess::Piece::King, libchess::Side::White},
+        {"startpos", libchess::squares::D8, libchess::Piece::Queen, libchess::Side::Black},
+        {"startpos", libchess::squares::B1, libchess::Piece::Knight, libchess::Side::White},
+        {"startpos", libchess::squares::H7, libchess::Piece::Pawn, libchess::Side::Black},
+        {"4k3/8/8/8/8/8/8/R3K2b w Q - 0 1", libchess::squares::A1, libchess::Piece::Rook, libchess::Side::White},
+        {"4k3/8/8/8/8/8/8/R3K2b w Q - 0 1", libchess::squares::H1, libchess::Piece::Bishop, libchess::Side::Black},
+    }};
+
+    for (const auto &[fen, sq, piece, side] : tests) {
+        INFO(fen);
+        INFO(sq);
+        const libchess::Position pos{fen};
+        REQUIRE(pos.piece_on(sq) == piece);
+        REQUIRE(pos.owner_on(sq) == side);
+    }
+}
+
+TEST_CASE("Position::piece_on() -- Empty") {
+    const libchess::Position pos{"startpos"};
+    REQUIRE(pos.piece_on(libchess::squares::E4) == libchess::Piece::None);
+    REQUIRE(pos.piece_on(libchess::squares::A3) == libchess::Piece::None);
+}
+
+TEST_CASE("Position::piece_on() -- Makemove & undomove") {
+    using tuple_type = std::tuple<std::string, std::string, std::array<libchess::Square, 4>>;
+
+    // Squares touched by the move that get checked before, during, and after
+    const std::array<tuple_type, 5> tests = {{
+        {"startpos",
+         "e2e4",
+         {{libchess::squares::E2, libchess::squares::E4, libchess::squares::E3, libchess::squares::E1}}},
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1",
+         "e5d6",
+         {{libchess::squares::E5, libchess::squares::D6, libchess::squares::D5, libchess::squares::E6}}},
+        {"4k3/1P6/8/8/8/8/8/4K3 w - - 0 1",
+         "b7b8q",
+         {{libchess::squares::B7, libchess::squares::B8, libchess::squares::A8, libchess::squares::C8}}},
+        {"r3k3/8/8/8/8/8/8/R3K2R w KQq - 0 1",
+         "e1g1",
+         {{libchess::squares::E1, libchess::squares::F1, libchess::squares::G1, libchess::squares::H1}}},
+        {"r3k3/8/8/8/8/8/8/R3K2R w KQq - 0 1",
+         "e1c1",
+         {{libchess::squares::A1, libchess::squares::C1, libchess::squares::D1, libchess::squares::E1}}},
+    }};
+
+    for (const auto &[fen, movestr, squares] : tests) {
+        INFO(fen);
+        INFO(movestr);
+        auto pos = libchess::Position{fen};
+        const auto before = pos;
+
+        pos.makemove(movestr);
+        REQUIRE(pos.valid());
+        for (const auto &sq : squares) {
+            const auto bb = libchess::Bitboard{sq};
+            auto expected = libchess::Piece::None;
+            for (const auto p : libchess::pieces) {
+                if (pos.occupancy(p) & bb) {
+                    expected = p;
+                }
+            }
+            REQUIRE(pos.piece_on(sq) == expected);
+        }
+
+        pos.undomove();
+        for (const auto &sq : squares) {
+            REQUIRE(pos.piece_on(sq) == before.piece_on(sq));
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include <array>
+#include <libchess/position.hpp>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "catch.hpp"
+
+TEST_CASE("SAN - Known moves") {
+    using tuple_type = std::tuple<std::string, std::string, std::string>;
+
+    const std::array<tuple_type, 18> tests = {{
+        {"startpos", "e2e4", "e4"},
+        {"startpos", "g1f3", "Nf3"},
+        // Captures
+        {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2", "e4d5", "exd5"},
+        {"rnbqkbnr/pppp1ppp/8/4p3/8/5N2/PPPPPPPP/RNBQKB1R w KQkq - 0 2", "f3e5", "Nxe5"},
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6", "exd6"},
+        // Disambiguation by file, rank and square
+        {"4k3/8/8/8/8/5N2/8/1N2K3 w - - 0 1", "b1d2", "Nbd2"},
+        {"4k3/8/8/8/8/8/4R3/R3K3 b - - 0 1", "e8d8", "Kd8"},
+        {"4k3/R7/8/8/8/8/8/R3K3 w - - 0 1", "a1a4", "R1a4"},
+        {"2k5/8/8/8/4Q2Q/8/8/K6Q w - - 0 1", "h4e1", "Qh4e1"},
+        {"2k5/8/8/8/4Q2Q/8/8/K6Q w - - 0 1", "h4h2", "Q4h2"},
+        // Promotions
+        {"8/4P3/8/8/8/8/k7/4K3 w - - 0 1", "e7e8q", "e8=Q"},
+        {"3r4/4P3/8/8/8/8/k7/4K3 w - - 0 1", "e7d8n", "exd8=N"},
+        // Check and mate
+        {"4k3/8/8/8/8/8/8/R3K3 w - - 0 1", "a1a8", "Ra8+"},
+        {"r1bqkbnr/pppp1ppp/2n5/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 0 4", "h5f7", "Qxf7#"},
+        // Castling
+        {"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", "e1g1", "O-O"},
+        {"r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1", "e8c8", "O-O-O"},
+        {"4k3/8/8/8/8/8/8/RK5R w HA - 0 1", "b1a1", "O-O-O"},
+        {"4k3/8/8/8/8/8/8/6KR w H - 0 1", "g1h1", "O-O"},
+    }};
+
+    for (const auto &[fen, movestr, san] : tests) {
+        INFO(fen);
+        INFO(movestr);
+        const auto pos = libchess::Position{fen, true};
+        const auto move = pos.parse_move(movestr);
+
+        REQUIRE(pos.san_string(move) == san);
+        REQUIRE(pos.parse_san(san) == move);
+    }
+}
+
+TEST_CASE("SAN - Round trip every legal move") {
+    using pair_type = std::pair<std::string, bool>;
+
+    const std::array<pair_type, 8> fens = {{
+        {"startpos", false},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", false},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", false},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", false},
+        {"R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1", false},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", false},
+        {"qnnrkrbb/pppppppp/8/8/8/8/PPPPPPPP/BBQNNRKR w HFfd - 0 1", true},
+        {"1rk2r2/8/8/8/8/8/8/1RK2R2 w FBfb - 0 1", true},
+    }};
+
+    for (const auto &[fen, dfrc] : fens) {
+        INFO(fen);
+        const auto pos = libchess::Position{fen, dfrc};
+        libchess::MoveList moves;
+        pos.legal_moves(moves);
+        std::vector<libchess::Position::SanString> sans(moves.size());
+        pos.write_san(moves, sans.data());
+
+        std::set<std::string> seen;
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            const auto san = std::string(sans[i].data());
+            INFO(san);
+            REQUIRE(san.size() <= libchess::Position::max_san_size);
+            REQUIRE(san == pos.san_string(moves[i]));
+            REQUIRE(pos.try_parse_san(san) == moves[i]);
+            seen.insert(san);
+        }
+        REQUIRE(seen.size() == moves.size());
+    }
+}
+
+TEST_CASE("SAN - Suffixes and loose notation") {
+    const auto pos = libchess::Position{"r3k2r/8/8/8/8/8/4P3/R3K1NR w KQkq - 0 1"};
+    REQUIRE(pos.parse_san("Nf3!?") == pos.parse_move("g1f3"));
+    REQUIRE(pos.parse_san("e4+") == pos.parse_move("e2e4"));
+    REQUIRE(pos.parse_san("0-0-0") == pos.parse_move("e1c1"));
+    REQUIRE(pos.parse_san("Ra8") == pos.parse_move("a1a8"));
+    REQUIRE(pos.parse_san("Rxa8") == pos.parse_move("a1a8"));
+    REQUIRE(pos.parse_san("Ng1f3") == pos.parse_move("g1f3"));
+}
+
+TEST_CASE("SAN - Rejects") {
+    const std::array<std::string, 12> strings = {{
+        "",
+        "e5",
+        "Nd2",
+        "Nbe2",
+        "Ke3",
+        "O-O",
+        "e2e5",
+        "Zf3",
+        "Nf3x",
+        "N3",
+        "e4=Q",
+        "Qe2=N",
+    }};
+
+    const auto pos = libchess::Position{"4k3/8/8/8/8/1N3N2/4P3/4K2R w - - 0 1"};
+    for (const auto &str : strings) {
+        INFO(str);
+        REQUIRE(!pos.try_parse_san(str));
+        REQUIRE_THROWS_AS(pos.parse_san(str), std::invalid_argument);
+    }
+}
@@ -0,0 +1,64 @@
+#include <array>
+#include <libchess/position.hpp>
+#include <string>
+#include "catch.hpp"
+
+TEST_CASE("Position::see()") {
+    using pair_type = std::pair<std::string, std::string>;
+
+    const std::array<std::pair<pair_type, int>, 12> tests = {{
+        // Undefended
+        {{"1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "e1e5"}, 100},
+        // Defended, with x-rays behind both sides
+        {{"1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "d3e5"}, -200},
+        // Quiet move to an attacked square
+        {{"4k3/8/8/3p4/8/8/6Q1/4K3 w - - 0 1", "g2e4"}, -900},
+        // The knight is pinned and can't recapture
+        {{"4k3/4n3/8/3p4/8/2N5/8/4R2K w - - 0 1", "c3d5"}, 100},
+        {{"4k3/4n3/8/3p4/8/2N5/8/7K w - - 0 1", "c3d5"}, -200},
+        // A pinned rook can still capture along the pin
+        {{"4k3/4r3/8/8/8/3Q4/8/4R2K w - - 0 1", "d3e4"}, -400},
+        // En passant, the captured pawn opens the file for the rook
+        {{"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6"}, 100},
+        {{"4k3/2p5/8/3pP3/8/8/8/3RK3 w - d6 0 1", "e5d6"}, 100},
+        // Promotions
+        {{"4k3/1P6/8/8/8/8/8/4K3 w - - 0 1", "b7b8q"}, 800},
+        {{"r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1", "b7b8q"}, -100},
+        {{"r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1", "b7a8n"}, 700},
+        // The king recaptures once nothing else can
+        {{"3rk3/8/8/8/8/8/3p4/3QK3 w - - 0 1", "d1d2"}, -300},
+    }};
+
+    for (const auto &[pair, expected] : tests) {
+        const auto &[fen, movestr] = pair;
+        INFO(fen);
+        INFO(movestr);
+        const auto pos = libchess::Position{fen};
+        const auto move = pos.parse_move(movestr);
+        REQUIRE(pos.see(move) == expected);
+        REQUIRE(pos.see_ge(move, expected));
+        REQUIRE(!pos.see_ge(move, expected + 1));
+    }
+}
+
+TEST_CASE("Position::see_ge() agrees with see()") {
+    const std::array<std::string, 5> fens = {{
+        "startpos",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    }};
+
+    for (const auto &fen : fens) {
+        INFO(fen);
+        const auto pos = libchess::Position{fen};
+        for (const auto &move : pos.legal_moves()) {
+            INFO(static_cast<std::string>(move));
+            const auto value = pos.see(move);
+            for (int threshold = -1000; threshold <= 1000; threshold += 50) {
+                REQUIRE(pos.see_ge(move, threshold) == (value >= threshold));
+            }
+        }
+    }
+}
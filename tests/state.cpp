@@ -0,0 +1,86 @@
+#include <array>
+#include <cstdint>
+#include <libchess/bitboard.hpp>
+#include <libchess/position.hpp>
+#include <string>
+#include "catch.hpp"
+
+namespace {
+
+void require_same(const libchess::Position::StateInfo &a, const libchess::Position::StateInfo &b) {
+    REQUIRE(a.checkers == b.checkers);
+    REQUIRE(a.pinned_diagonal == b.pinned_diagonal);
+    REQUIRE(a.pinned_orthogonal == b.pinned_orthogonal);
+    REQUIRE(a.diagonal_pin_rays == b.diagonal_pin_rays);
+    REQUIRE(a.orthogonal_pin_rays == b.orthogonal_pin_rays);
+    REQUIRE(a.check_mask == b.check_mask);
+    REQUIRE(a.king_allowed == b.king_allowed);
+}
+
+}  // namespace
+
+TEST_CASE("Position::state() -- Pins") {
+    using tuple_type = std::tuple<std::string, std::uint64_t, std::uint64_t>;
+
+    const std::array<tuple_type, 5> positions = {{
+        {"startpos", 0x0, 0x0},
+        {"b2r2b1/8/2PPP3/q1PKP1r1/2PPP3/8/b2r2q1/7k w - - 0 1", 0x140014000000, 0x81408000000},
+        {"7k/8/4r2b/8/4NN2/4K3/8/8 w - - 0 1", 0x20000000, 0x10000000},
+        {"4k3/8/4r3/3pP3/8/8/8/4K3 w - d6 0 2", 0x0, 0x1000000000},
+        {"4k3/8/8/8/1b6/8/3P4/4K3 w - - 0 1", 0x800, 0x0},
+    }};
+
+    for (const auto &[fen, diagonal, orthogonal] : positions) {
+        INFO(fen);
+        const libchess::Position pos{fen};
+        REQUIRE(pos.state().pinned_diagonal == libchess::Bitboard(diagonal));
+        REQUIRE(pos.state().pinned_orthogonal == libchess::Bitboard(orthogonal));
+        REQUIRE(pos.pinned() == pos.pinned(pos.turn(), pos.king_position(pos.turn())));
+    }
+}
+
+TEST_CASE("Position::state() -- Check mask") {
+    using pair_type = std::pair<std::string, std::uint64_t>;
+
+    const std::array<pair_type, 4> positions = {{
+        {"startpos", 0xFFFFFFFFFFFFFFFF},
+        {"4k3/8/8/8/8/8/8/r3K3 w - - 0 1", 0xF},
+        {"4k3/8/8/8/8/3n4/8/4K3 w - - 0 1", 0x80000},
+        {"4k3/8/8/8/8/3n4/8/r3K3 w - - 0 1", 0x0},
+    }};
+
+    for (const auto &[fen, mask] : positions) {
+        INFO(fen);
+        const libchess::Position pos{fen};
+        REQUIRE(pos.state().check_mask == libchess::Bitboard(mask));
+    }
+}
+
+TEST_CASE("Position::state() -- Updated by makemove and undomove") {
+    const std::array<std::string, 4> fens = {{
+        "startpos",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    }};
+
+    for (const auto &fen : fens) {
+        INFO(fen);
+        auto pos = libchess::Position{fen};
+        const auto before = pos.state();
+
+        for (const auto &move : pos.legal_moves()) {
+            INFO(static_cast<std::string>(move));
+            pos.makemove(move);
+            require_same(pos.state(), pos.calculate_state(pos.turn()));
+            REQUIRE(pos.checkers() == pos.attackers(pos.king_position(pos.turn()), !pos.turn()));
+            pos.undomove();
+            require_same(pos.state(), before);
+        }
+
+        pos.makenull();
+        require_same(pos.state(), pos.calculate_state(pos.turn()));
+        pos.undonull();
+        require_same(pos.state(), before);
+    }
+}
@@ -0,0 +1,78 @@
+#include <array>
+#include <cstdint>
+#include <libchess/position.hpp>
+#include <string>
+#include <utility>
+#include "catch.hpp"
+
+using Status = libchess::Position::Status;
+
+TEST_CASE("Position::status()") {
+    using pair_type = std::pair<std::string, Status>;
+
+    const std::array<pair_type, 12> tests = {{
+        {"startpos", Status::Ongoing},
+        {"rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3", Status::Checkmate},
+        {"8/8/8/8/8/3k4/8/3K1r2 w - - 1 2", Status::Checkmate},
+        {"k7/8/1Q6/8/8/8/8/7K b - - 0 1", Status::Stalemate},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 100 1", Status::FiftyMoves},
+        // Checkmate beats the fifty move rule
+        {"8/8/8/8/8/3k4/8/3K1r2 w - - 100 60", Status::Checkmate},
+        {"4k3/8/8/8/8/8/8/4K3 w - - 0 1", Status::InsufficientMaterial},
+        {"4k3/8/8/8/8/8/8/4KN2 w - - 0 1", Status::InsufficientMaterial},
+        {"4k3/8/8/8/8/8/8/4KB2 w - - 0 1", Status::InsufficientMaterial},
+        {"4kb2/8/8/8/8/8/8/2B1K3 w - - 0 1", Status::InsufficientMaterial},
+        {"4k1b1/8/8/8/8/8/8/2B1K3 w - - 0 1", Status::Ongoing},
+        {"4k3/8/8/8/8/8/8/3NKN2 w - - 0 1", Status::Ongoing},
+    }};
+
+    for (const auto &[fen, status] : tests) {
+        INFO(fen);
+        const libchess::Position pos{fen};
+        REQUIRE(pos.status() == status);
+        REQUIRE(pos.is_terminal() == (status != Status::Ongoing && status != Status::InsufficientMaterial));
+    }
+}
+
+TEST_CASE("Position::status() threefold") {
+    libchess::Position pos{"startpos"};
+    for (const auto &movestr : {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1", "f6g8"}) {
+        REQUIRE(pos.status() == Status::Ongoing);
+        pos.makemove(movestr);
+    }
+    REQUIRE(pos.status() == Status::Threefold);
+}
+
+TEST_CASE("Position::has_legal_move() random games") {
+    const std::array<std::string, 4> fens = {{
+        "startpos",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "4k3/8/8/8/8/8/2q5/R3K2R w KQ - 0 1",
+    }};
+
+    std::uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    const auto random = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    };
+
+    for (const auto &fen : fens) {
+        for (int game = 0; game < 20; ++game) {
+            libchess::Position pos{fen};
+            for (int ply = 0; ply < 200; ++ply) {
+                INFO(pos.get_fen());
+                const auto moves = pos.legal_moves();
+                REQUIRE(pos.has_legal_move() == !moves.empty());
+                REQUIRE(pos.is_checkmate() == (moves.empty() && pos.in_check()));
+                REQUIRE(pos.is_stalemate() == (moves.empty() && !pos.in_check()));
+                if (moves.empty()) {
+                    break;
+                }
+                pos.makemove(moves[random() % moves.size()]);
+            }
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <cstdint>
+#include <libchess/position.hpp>
+#include <libchess/tt.hpp>
+#include <thread>
+#include <vector>
+#include "catch.hpp"
+
+TEST_CASE("TT -- Store and probe") {
+    libchess::TT tt{1};
+    const auto hash = libchess::Position{"startpos"}.hash();
+    std::uint64_t data = 0;
+    int depth = 0;
+
+    REQUIRE(tt.size() == 1024 * 1024 / 16);
+    REQUIRE(!tt.probe(hash, data, depth));
+
+    tt.store(hash, 123456, 7);
+    REQUIRE(tt.probe(hash, data, depth));
+    REQUIRE(data == 123456);
+    REQUIRE(depth == 7);
+    REQUIRE(!tt.probe(hash ^ 1, data, depth));
+
+    // The same position is always overwritten
+    tt.store(hash, libchess::TT::max_data, 2);
+    REQUIRE(tt.probe(hash, data, depth));
+    REQUIRE(data == libchess::TT::max_data);
+    REQUIRE(depth == 2);
+
+    tt.clear();
+    REQUIRE(!tt.probe(hash, data, depth));
+}
+
+TEST_CASE("TT -- Replace the shallowest entry") {
+    libchess::TT tt{1};
+    const std::uint64_t num_buckets = tt.size() / 4;
+    const auto hash = [num_buckets](const std::uint64_t i) {
+        return 0x1234 + i * num_buckets;
+    };
+    std::uint64_t data = 0;
+    int depth = 0;
+
+    // All in the same bucket
+    tt.store(hash(0), 0, 5);
+    tt.store(hash(1), 1, 3);
+    tt.store(hash(2), 2, 7);
+    tt.store(hash(3), 3, 6);
+    tt.store(hash(4), 4, 4);
+
+    REQUIRE(!tt.probe(hash(1), data, depth));
+    for (const std::uint64_t i : {0, 2, 3, 4}) {
+        REQUIRE(tt.probe(hash(i), data, depth));
+        REQUIRE(data == i);
+    }
+}
+
+TEST_CASE("TT -- hashfull") {
+    libchess::TT tt{1};
+    REQUIRE(tt.hashfull() == 0);
+
+    std::uint64_t hash = 0x9E3779B97F4A7C15ULL;
+    for (std::size_t i = 0; i < 4 * tt.size(); ++i) {
+        hash = hash * 6364136223846793005ULL + 1442695040888963407ULL;
+        tt.store(hash, i & libchess::TT::max_data, 1);
+    }
+    REQUIRE(tt.hashfull() > 950);
+
+    tt.clear();
+    REQUIRE(tt.hashfull() == 0);
+}
+
+TEST_CASE("TT -- Concurrent access") {
+    // Every hit has to be the data stored for that hash, no matter how the threads interleave
+    libchess::TT tt{1};
+    std::atomic<int> bad{0};
+    std::atomic<int> hits{0};
+
+    const auto worker = [&](const std::uint64_t seed) {
+        std::uint64_t hash = seed;
+        for (int i = 0; i < 200'000; ++i) {
+            hash = hash * 6364136223846793005ULL + 1442695040888963407ULL;
+            const auto key = hash % 50'000;
+            std::uint64_t data = 0;
+            int depth = 0;
+            if (tt.probe(key, data, depth)) {
+                hits++;
+                bad += data != (key * 31 & libchess::TT::max_data) || depth != static_cast<int>(key % 64);
+            }
+            tt.store(key, key * 31 & libchess::TT::max_data, static_cast<int>(key % 64));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::uint64_t i = 0; i < 4; ++i) {
+        threads.emplace_back(worker, i + 1);
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    REQUIRE(hits > 0);
+    REQUIRE(bad == 0);
+}